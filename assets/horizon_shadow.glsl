@@ -0,0 +1,21 @@
+// Dùng chung cho terrain.vert (Gouraud) và terrain.frag (Flat/Phong) qua #include "horizon_shadow.glsl"
+uniform sampler2DArray horizonMap; // Góc chân trời tính trước cho bóng đổ
+
+// Bóng đổ tự thân từ horizon map (8 hướng, 2 layer RGBA)
+// Trả về 1 nếu nguồn sáng nằm trên đường chân trời theo hướng tới nó, 0 nếu bị núi che
+float horizonShadow(vec3 localPos, vec3 lightDir) {
+    vec2 uv = (localPos.xz + 0.5) / vec2(textureSize(horizonMap, 0).xy);
+    vec4 h0 = textureLod(horizonMap, vec3(uv, 0.0), 0.0);
+    vec4 h1 = textureLod(horizonMap, vec3(uv, 1.0), 0.0);
+    float horizons[9] = float[9](h0.r, h0.g, h0.b, h0.a, h1.r, h1.g, h1.b, h1.a, h0.r);
+
+    // Nội suy giữa 2 hướng kề nhau theo phương vị của nguồn sáng
+    float azimuth = atan(lightDir.z, lightDir.x);
+    if (azimuth < 0.0) azimuth += 6.28318531;
+    float f = azimuth / 6.28318531 * 8.0;
+    int i = min(int(f), 7);
+    float horizon = mix(horizons[i], horizons[i + 1], f - float(i)) * 1.57079633;
+
+    float elevation = asin(clamp(lightDir.y, -1.0, 1.0));
+    return smoothstep(horizon - 0.03, horizon + 0.03, elevation);
+}
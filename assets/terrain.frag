@@ -1,18 +1,39 @@
 #version 330 core
+// Biến thể chọn lúc biên dịch, phải khớp với terrain.vert (LIGHTING_FLAT/GOURAUD/PHONG)
+#if !defined(LIGHTING_FLAT) && !defined(LIGHTING_GOURAUD) && !defined(LIGHTING_PHONG)
+#define LIGHTING_GOURAUD
+#endif
+
+out vec4 FragColor;
+
+#if defined(LIGHTING_GOURAUD)
+in vec3 LightingColor;
+
+void main() {
+    // [CG.6] Gouraud Shading - màu được nội suy từ đỉnh (Lambert)
+    FragColor = vec4(LightingColor, 1.0);
+}
+#else
 in vec3 FragPos;
+#if defined(LIGHTING_FLAT)
 flat in vec3 FlatNormal;  // flat qualifier - không nội suy (cho Flat Shading)
+#else
 in vec3 SmoothNormal;     // smooth - có nội suy (cho Smooth Shading)
-in vec3 LightDir;
-in vec3 ViewDir;
-in vec3 LightingColor;
+#endif
+in float AO; // Ambient Occlusion bake sẵn - thung lũng tối hơn đỉnh núi
+in vec3 LocalPos;
 
-uniform vec3 lightPos;
-uniform vec3 viewPos;
-uniform vec3 lightColor;
-uniform int shadingModel; // 0 = Lambert (Gouraud), 1 = Phong
-uniform int displayMode; // 0 = Wireframe, 1 = Flat, 2 = Smooth
+// Trạng thái chung mỗi frame (camera + ánh sáng) - UBO std140, cập nhật 1 lần/frame cho mọi program
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    vec3 lightPos;
+    vec3 lightColor;
+    float time;
+};
 
-out vec4 FragColor;
+#include "horizon_shadow.glsl"
 
 void main() {
     // Màu sắc theo độ cao - tạo gradient tự nhiên cho đồi núi
@@ -21,7 +42,7 @@ void main() {
     vec3 grassColor = vec3(0.22, 0.53, 0.2);    // Xanh lá
     vec3 rockColor = vec3(0.43, 0.39, 0.33);    // Đá xám
     vec3 snowColor = vec3(0.93, 0.93, 0.98);    // Tuyết trắng
-    
+
     vec3 objectColor;
     if (height < 3.0) {
         // Vùng thấp - đất và cỏ
@@ -39,52 +60,49 @@ void main() {
         float t = clamp((height - 13.0) / 5.0, 0.0, 1.0);
         objectColor = mix(rockColor, snowColor, t);
     }
-    
-    if (displayMode == 1) {
-        // [CG.6] Flat Shading - Tô bóng hằng (không nội suy)
-        // Sử dụng FlatNormal (flat qualifier) - tất cả fragment trong tam giác dùng cùng normal
-        vec3 norm = normalize(FlatNormal);
-        vec3 lightDir = normalize(lightPos - FragPos);
-        
-        // Ambient
-        float ambientStrength = 0.15;
-        vec3 ambient = ambientStrength * lightColor;
-        
-        // Diffuse (Lambert) - mỗi tam giác có một màu đồng nhất
-        float diff = max(dot(norm, lightDir), 0.0);
-        vec3 diffuse = diff * lightColor;
-        
-        // Flat shading chỉ dùng ambient + diffuse, không có specular
-        vec3 result = (ambient + diffuse) * objectColor;
-        FragColor = vec4(result, 1.0);
-        return;
-    }
-    
-    if (shadingModel == 0) {
-        // [CG.6] Gouraud Shading - màu được nội suy từ đỉnh (Lambert)
-    FragColor = vec4(LightingColor, 1.0);
-    } else {
-        // [CG.6] Phong Shading Model - tính toán tại fragment
-        vec3 norm = normalize(SmoothNormal); // Sử dụng smooth normal cho Smooth Shading
-        vec3 lightDir = normalize(lightPos - FragPos);
-        vec3 viewDir = normalize(viewPos - FragPos);
-        
-        // Ambient
-        float ambientStrength = 0.15;
-        vec3 ambient = ambientStrength * lightColor;
-        
-        // Diffuse (Lambert)
-        float diff = max(dot(norm, lightDir), 0.0);
-        vec3 diffuse = diff * lightColor;
-        
-        // Specular (Phong) - [CG.6] Độ bóng
-        float specularStrength = 0.5;
-        vec3 reflectDir = reflect(-lightDir, norm);
-        float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32.0); // Shininess = 32
-        vec3 specular = specularStrength * spec * lightColor;
-        
-        // Tổng hợp ánh sáng Phong
-        vec3 result = (ambient + diffuse + specular) * objectColor;
-        FragColor = vec4(result, 1.0);
-    }
-}
\ No newline at end of file
+
+#if defined(LIGHTING_FLAT)
+    // [CG.6] Flat Shading - Tô bóng hằng (không nội suy)
+    // Sử dụng FlatNormal (flat qualifier) - tất cả fragment trong tam giác dùng cùng normal
+    vec3 norm = normalize(FlatNormal);
+    vec3 lightDir = normalize(lightPos - FragPos);
+
+    // Ambient
+    float ambientStrength = 0.15;
+    vec3 ambient = ambientStrength * AO * lightColor;
+
+    // Diffuse (Lambert) - mỗi tam giác có một màu đồng nhất
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse = diff * lightColor;
+
+    // Flat shading chỉ dùng ambient + diffuse, không có specular
+    float shadow = horizonShadow(LocalPos, lightDir);
+    vec3 result = (ambient + diffuse * shadow) * objectColor;
+    FragColor = vec4(result, 1.0);
+#else
+    // [CG.6] Phong Shading Model - tính toán tại fragment
+    vec3 norm = normalize(SmoothNormal); // Sử dụng smooth normal cho Smooth Shading
+    vec3 lightDir = normalize(lightPos - FragPos);
+    vec3 viewDir = normalize(viewPos - FragPos);
+
+    // Ambient
+    float ambientStrength = 0.15;
+    vec3 ambient = ambientStrength * AO * lightColor;
+
+    // Diffuse (Lambert)
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse = diff * lightColor;
+
+    // Specular (Phong) - [CG.6] Độ bóng
+    float specularStrength = 0.5;
+    vec3 reflectDir = reflect(-lightDir, norm);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32.0); // Shininess = 32
+    vec3 specular = specularStrength * spec * lightColor;
+
+    // Tổng hợp ánh sáng Phong
+    float shadow = horizonShadow(LocalPos, lightDir);
+    vec3 result = (ambient + (diffuse + specular) * shadow) * objectColor;
+    FragColor = vec4(result, 1.0);
+#endif
+}
+#endif
@@ -1,45 +1,76 @@
 #version 330 core
+// Biến thể được chọn lúc biên dịch bằng #define chèn sau #version (Shader permutations):
+//   LIGHTING_FLAT     - Flat Shading, pháp tuyến không nội suy
+//   LIGHTING_GOURAUD  - Lambert tính tại đỉnh, fragment chỉ nội suy màu
+//   LIGHTING_PHONG    - Phong tính tại fragment
+#if !defined(LIGHTING_FLAT) && !defined(LIGHTING_GOURAUD) && !defined(LIGHTING_PHONG)
+#define LIGHTING_GOURAUD
+#endif
+
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
+layout (location = 2) in float aAO; // Ambient Occlusion bake sẵn trên CPU
+
+// Trạng thái chung mỗi frame (camera + ánh sáng) - UBO std140, cập nhật 1 lần/frame cho mọi program
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    vec3 lightPos;
+    vec3 lightColor;
+    float time;
+};
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-uniform vec3 lightPos;
-uniform vec3 viewPos;
-uniform vec3 lightColor;
-uniform int shadingModel; // 0 = Lambert, 1 = Phong
-uniform int displayMode; // 0 = Wireframe, 1 = Flat, 2 = Smooth
+uniform mat3 normalMatrix; // transpose(inverse(mat3(model))) - tính sẵn trên CPU
+
+#if defined(LIGHTING_GOURAUD)
+out vec3 LightingColor; // Gouraud shading (Lambert only)
 
+#include "horizon_shadow.glsl"
+#else
 out vec3 FragPos;
+#if defined(LIGHTING_FLAT)
 flat out vec3 FlatNormal; // flat qualifier cho Flat Shading - không nội suy
+#else
 out vec3 SmoothNormal;    // smooth normal cho Smooth Shading - có nội suy
-out vec3 LightDir;
-out vec3 ViewDir;
-out vec3 LightingColor; // Gouraud shading (Lambert only)
+#endif
+out float AO;
+out vec3 LocalPos; // Toạ độ lưới địa hình (để tra horizon map)
+#endif
 
 void main() {
     // Tính vị trí đỉnh trong thế giới thực
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    gl_Position = projection * view * vec4(FragPos, 1.0);
+    vec3 worldPos = vec3(model * vec4(aPos, 1.0));
+    gl_Position = projection * view * vec4(worldPos, 1.0);
 
     // Transform normal to world space
-    FlatNormal = normalize(aNormal);  // Cho Flat Shading
-    SmoothNormal = normalize(aNormal); // Cho Smooth Shading
-    LightDir = normalize(lightPos - FragPos);
-    ViewDir = normalize(viewPos - FragPos);
+    vec3 worldNormal = normalize(normalMatrix * aNormal);
+
+#if defined(LIGHTING_GOURAUD)
+    vec3 lightDir = normalize(lightPos - worldPos);
 
     //  Lambert Illumination (Diffuse) - cho Gouraud
-    float diff = max(dot(SmoothNormal, LightDir), 0.0);
+    float diff = max(dot(worldNormal, lightDir), 0.0);
     vec3 diffuse = diff * lightColor;
 
     // Ambient (Giả lập ánh sáng môi trường)
     float ambientStrength = 0.15;
-    vec3 ambient = ambientStrength * lightColor;
+    vec3 ambient = ambientStrength * aAO * lightColor;
 
     // Màu vật thể (đất núi màu xanh lá đậm)
-    vec3 objectColor = vec3(0.2, 0.5, 0.2); 
+    vec3 objectColor = vec3(0.2, 0.5, 0.2);
 
     // Gouraud: chỉ tính Lambert tại vertex
-    LightingColor = (ambient + diffuse) * objectColor;
-}
\ No newline at end of file
+    LightingColor = (ambient + diffuse * horizonShadow(aPos, lightDir)) * objectColor;
+#else
+    FragPos = worldPos;
+#if defined(LIGHTING_FLAT)
+    FlatNormal = worldNormal;   // Cho Flat Shading
+#else
+    SmoothNormal = worldNormal; // Cho Smooth Shading
+#endif
+    AO = aAO;
+    LocalPos = aPos;
+#endif
+}
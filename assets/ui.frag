@@ -1,7 +1,18 @@
 #version 330 core
 out vec4 FragColor;
+
+#ifdef UI_HUD
+in vec2 uv;
+in vec4 tint;
+uniform sampler2D fontAtlas; // R8: 1 trong glyph (và trong ô khối đặc), 0 ngoài glyph
+
+void main() {
+    FragColor = vec4(tint.rgb, tint.a * texture(fontAtlas, uv).r);
+}
+#else
 uniform vec3 color;
 
 void main() {
     FragColor = vec4(color, 1.0);
-}
\ No newline at end of file
+}
+#endif
@@ -1,7 +1,23 @@
 #version 330 core
-layout (location = 0) in vec3 aPos;
 uniform mat4 projection; // Orthographic projection
 
+#ifdef UI_HUD
+// HUD: chữ + hình chữ nhật gom chung một buffer, màu theo từng đỉnh
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec2 aUV;
+layout (location = 2) in vec4 aColor;
+out vec2 uv;
+out vec4 tint;
+
+void main() {
+    uv = aUV;
+    tint = aColor;
+    gl_Position = projection * vec4(aPos, 0.0, 1.0);
+}
+#else
+layout (location = 0) in vec3 aPos;
+
 void main() {
     gl_Position = projection * vec4(aPos, 1.0);
-}
\ No newline at end of file
+}
+#endif
@@ -2,10 +2,15 @@
 in vec3 FragPos;
 in vec3 Normal;
 
-uniform vec3 viewPos;
-uniform vec3 lightPos;
-uniform vec3 lightColor;
-uniform float time;
+// Trạng thái chung mỗi frame (camera + ánh sáng) - UBO std140, cập nhật 1 lần/frame cho mọi program
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    vec3 lightPos;
+    vec3 lightColor;
+    float time;
+};
 
 out vec4 FragColor;
 
@@ -1,10 +1,17 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
 
+// Trạng thái chung mỗi frame (camera + ánh sáng) - UBO std140, cập nhật 1 lần/frame cho mọi program
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    vec3 lightPos;
+    vec3 lightColor;
+    float time;
+};
+
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-uniform float time;
 
 out vec3 FragPos;
 out vec3 Normal;
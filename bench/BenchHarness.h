@@ -0,0 +1,116 @@
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+// Harness đo thời gian tối giản cho microbenchmark, không phụ thuộc thư viện ngoài
+// Mỗi case: warmup -> tự chọn số vòng lặp mỗi lần đo -> lặp lại nhiều lần -> median/p99 (ns/op)
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Ép compiler giữ lại giá trị đã tính (không bị loại bỏ như dead code)
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sinkPtr;
+    sinkPtr = &value;
+#endif
+}
+
+struct BenchResult {
+    string name;
+    long long iterations; // Số lần gọi trong một lần đo
+    int repetitions;
+    double medianNs, p99Ns, minNs, meanNs; // ns cho một lần gọi
+};
+
+class BenchHarness {
+public:
+    int warmupRuns = 3;
+    int repetitions = 31;
+    double targetRepNs = 2.0e6; // Mỗi lần đo kéo dài khoảng 2 ms
+    string filter;              // Chỉ chạy case có tên chứa chuỗi này
+    vector<BenchResult> results;
+
+    // fn(i) được gọi với i = 0..iterations-1 trong mỗi lần đo
+    template <typename Fn>
+    void run(const string& name, Fn fn) {
+        if (!filter.empty() && name.find(filter) == string::npos) return;
+
+        for (int w = 0; w < warmupRuns; ++w) measure(1, fn);
+
+        // Nhân đôi số vòng lặp tới khi một lần đo đủ dài so với độ phân giải đồng hồ
+        long long iterations = 1;
+        while (iterations < (1LL << 30)) {
+            double ns = measure(iterations, fn);
+            if (ns >= targetRepNs) break;
+            long long scaled = ns > 0.0 ? (long long)(iterations * targetRepNs / ns) : iterations * 16;
+            iterations = max(iterations * 2, min(scaled, iterations * 16));
+        }
+
+        vector<double> samples(repetitions);
+        for (int r = 0; r < repetitions; ++r) samples[r] = measure(iterations, fn) / iterations;
+        sort(samples.begin(), samples.end());
+
+        BenchResult res;
+        res.name = name;
+        res.iterations = iterations;
+        res.repetitions = repetitions;
+        res.medianNs = percentile(samples, 0.50);
+        res.p99Ns = percentile(samples, 0.99);
+        res.minNs = samples.front();
+        double sum = 0.0;
+        for (double s : samples) sum += s;
+        res.meanNs = sum / samples.size();
+        results.push_back(res);
+    }
+
+    void printTable(FILE* out) const {
+        fprintf(out, "%-34s %12s %12s %12s %10s\n", "benchmark", "median ns", "p99 ns", "min ns", "iters");
+        for (const BenchResult& r : results)
+            fprintf(out, "%-34s %12.2f %12.2f %12.2f %10lld\n", r.name.c_str(), r.medianNs, r.p99Ns, r.minNs, r.iterations);
+    }
+
+    void writeJson(FILE* out) const {
+        fprintf(out, "{\n  \"unit\": \"ns/op\",\n  \"benchmarks\": [\n");
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BenchResult& r = results[i];
+            fprintf(out, "    {\"name\": \"%s\", \"iterations\": %lld, \"repetitions\": %d, "
+                         "\"median\": %.3f, \"p99\": %.3f, \"min\": %.3f, \"mean\": %.3f}%s\n",
+                    escape(r.name).c_str(), r.iterations, r.repetitions,
+                    r.medianNs, r.p99Ns, r.minNs, r.meanNs, i + 1 < results.size() ? "," : "");
+        }
+        fprintf(out, "  ]\n}\n");
+    }
+
+private:
+    template <typename Fn>
+    static double measure(long long iterations, Fn& fn) {
+        auto start = chrono::steady_clock::now();
+        for (long long i = 0; i < iterations; ++i) fn(i);
+        return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+    }
+
+    // Nearest-rank trên mẫu đã sắp xếp
+    static double percentile(const vector<double>& sorted, double p) {
+        size_t rank = (size_t)(p * sorted.size() + 0.999999);
+        rank = min(max(rank, (size_t)1), sorted.size());
+        return sorted[rank - 1];
+    }
+
+    static string escape(const string& s) {
+        string out;
+        for (char c : s) {
+            if (c == '"' || c == '\\') out += '\\';
+            out += c;
+        }
+        return out;
+    }
+};
+
+#endif
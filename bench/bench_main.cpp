@@ -0,0 +1,257 @@
+// Bộ microbenchmark cho Math3D, Algorithms2D và Terrain
+// Chạy headless, không cần OpenGL context
+//   3DTerrainBench                 in bảng kết quả
+//   3DTerrainBench --json          in JSON ra stdout
+//   3DTerrainBench --filter Mat4   chỉ chạy các case có tên chứa "Mat4"
+//   3DTerrainBench --reps 51       số lần đo mỗi case
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#include "BenchHarness.h"
+#include "Math3D.h"
+#include "Algorithms2D.h"
+#include "Terrain.h"
+#include "HorizonMap.h"
+#include "Frustum.h"
+#include "UniformCache.h"
+#include "Profiler.h"
+
+// Bản cài đặt Mat4 cũ (vòng lặp vô hướng, constructor luôn khởi tạo identity) để đối chiếu
+struct LegacyMat4 {
+    float m[4][4];
+
+    LegacyMat4() {
+        for (int i = 0; i < 4; i++)
+            for (int j = 0; j < 4; j++) m[i][j] = (i == j) ? 1.0f : 0.0f;
+    }
+
+    LegacyMat4 operator*(const LegacyMat4& other) const {
+        LegacyMat4 res;
+        for (int i = 0; i < 4; i++) {
+            for (int j = 0; j < 4; j++) {
+                res.m[i][j] = 0;
+                for (int k = 0; k < 4; k++)
+                    res.m[i][j] += m[i][k] * other.m[k][j];
+            }
+        }
+        return res;
+    }
+
+    LegacyMat4 transpose() const {
+        LegacyMat4 res;
+        for (int i = 0; i < 4; i++)
+            for (int j = 0; j < 4; j++) res.m[i][j] = m[j][i];
+        return res;
+    }
+
+    Vec3 transformPoint(const Vec3& p) const {
+        return Vec3(p.x * m[0][0] + p.y * m[1][0] + p.z * m[2][0] + m[3][0],
+                    p.x * m[0][1] + p.y * m[1][1] + p.z * m[2][1] + m[3][1],
+                    p.x * m[0][2] + p.y * m[1][2] + p.z * m[2][2] + m[3][2]);
+    }
+};
+
+template <typename M>
+static void fill(M& mat, int seed) {
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 4; j++) mat.m[i][j] = (float)((i * 4 + j + seed) % 7) * 0.25f - 0.5f;
+}
+
+template <typename A, typename B>
+static float maxAbsDiff(const A& a, const B& b) {
+    float diff = 0.0f;
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 4; j++) diff = max(diff, fabsf(a.m[i][j] - b.m[i][j]));
+    return diff;
+}
+
+// Đường SIMD của Mat4 phải cho cùng kết quả với LegacyMat4 (sai thì benchmark vô nghĩa): in sai số lớn nhất
+// của multiply/transpose/transformPoint trên toàn bộ dữ liệu đầu vào, trả về false nếu vượt ngưỡng
+template <typename Mats, typename Legacy, typename Vecs>
+static bool checkMat4AgainstLegacy(const Mats& mats, const Legacy& legacy, const Vecs& vecs) {
+    const float TOLERANCE = 1e-5f; // Thứ tự cộng khác nhau -> lệch vài ulp
+    float multiplyDiff = 0.0f, transposeDiff = 0.0f, pointDiff = 0.0f;
+    int count = (int)mats.size();
+    for (int i = 0; i < count; i++) {
+        int k = (i + 1) % count;
+        multiplyDiff = max(multiplyDiff, maxAbsDiff(mats[i] * mats[k], legacy[i] * legacy[k]));
+        transposeDiff = max(transposeDiff, maxAbsDiff(mats[i].transpose(), legacy[i].transpose()));
+        Vec3 p = mats[i].transformPoint(vecs[i]), q = legacy[i].transformPoint(vecs[i]);
+        pointDiff = max(pointDiff, max(fabsf(p.x - q.x), max(fabsf(p.y - q.y), fabsf(p.z - q.z))));
+    }
+    fprintf(stderr, "max |simd - legacy|: multiply %g, transpose %g, transformPoint %g\n", multiplyDiff,
+            transposeDiff, pointDiff);
+    if (multiplyDiff <= TOLERANCE && transposeDiff <= TOLERANCE && pointDiff <= TOLERANCE) return true;
+    fprintf(stderr, "ERROR::BENCH::MAT4_MISMATCH: SIMD Mat4 differs from LegacyMat4 (tolerance %g)\n", TOLERANCE);
+    return false;
+}
+
+// Cull theo lô phải cho đúng danh sách của testSphere/testAabb từng phần tử (kể cả nhánh bỏ sớm theo hai mặt bên)
+static bool checkCullAgainstScalar(const Frustum& frustum, const SphereBatch& spheres, const AabbBatch& boxes) {
+    vector<uint32_t> expectedSpheres, expectedBoxes, visible;
+    for (size_t i = 0; i < spheres.size(); ++i)
+        if (frustum.testSphere(Vec3(spheres.cx[i], spheres.cy[i], spheres.cz[i]), spheres.radius[i]))
+            expectedSpheres.push_back((uint32_t)i);
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        Vec3 c(boxes.cx[i], boxes.cy[i], boxes.cz[i]), e(boxes.ex[i], boxes.ey[i], boxes.ez[i]);
+        if (frustum.testAabb(c - e, c + e)) expectedBoxes.push_back((uint32_t)i);
+    }
+    bool ok = true;
+    frustum.cullSpheres<f32x4>(spheres, visible);
+    ok = ok && visible == expectedSpheres;
+    frustum.cullSpheres<f32x8>(spheres, visible);
+    ok = ok && visible == expectedSpheres;
+    frustum.cullAabbs<f32x4>(boxes, visible);
+    ok = ok && visible == expectedBoxes;
+    frustum.cullAabbs<f32x8>(boxes, visible);
+    ok = ok && visible == expectedBoxes;
+    fprintf(stderr, "frustum: %zu / %zu spheres, %zu / %zu boxes visible\n", expectedSpheres.size(), spheres.size(),
+            expectedBoxes.size(), boxes.size());
+    if (!ok) fprintf(stderr, "ERROR::BENCH::CULL_MISMATCH: batch culling differs from testSphere/testAabb\n");
+    return ok;
+}
+
+static void usage(const char* argv0) {
+    fprintf(stderr, "Usage: %s [--json] [--filter <name>] [--reps <n>]\n", argv0);
+}
+
+int main(int argc, char** argv) {
+    BenchHarness bench;
+    bool json = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--json") == 0) json = true;
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) bench.filter = argv[++i];
+        else if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc) bench.repetitions = max(1, atoi(argv[++i]));
+        else { usage(argv[0]); return 1; }
+    }
+
+    // Dữ liệu đầu vào xoay vòng qua COUNT phần tử để compiler không gộp các lần gọi
+    const int COUNT = 64;
+    const int MASK = COUNT - 1;
+
+    // --- Math3D ---
+    vector<Mat4> mats(COUNT), matOut(COUNT);
+    vector<LegacyMat4> legacy(COUNT), legacyOut(COUNT);
+    vector<Vec3> vecs(COUNT), vecOut(COUNT);
+    for (int i = 0; i < COUNT; i++) {
+        fill(mats[i], i);
+        fill(legacy[i], i);
+        vecs[i] = Vec3(1.0f + i, 0.5f * i - 7.0f, 3.0f - 0.25f * i);
+    }
+    if (!checkMat4AgainstLegacy(mats, legacy, vecs)) return 2;
+
+    bench.run("Mat4 multiply (legacy scalar)", [&](long long i) {
+        legacyOut[i & MASK] = legacy[i & MASK] * legacy[(i + 1) & MASK];
+    });
+    bench.run("Mat4 multiply", [&](long long i) { matOut[i & MASK] = mats[i & MASK] * mats[(i + 1) & MASK]; });
+    bench.run("Mat4 transpose (legacy scalar)", [&](long long i) { legacyOut[i & MASK] = legacy[i & MASK].transpose(); });
+    bench.run("Mat4 transpose", [&](long long i) { matOut[i & MASK] = mats[i & MASK].transpose(); });
+    bench.run("Mat4 transformPoint (legacy scalar)", [&](long long i) {
+        vecOut[i & MASK] = legacy[i & MASK].transformPoint(vecs[i & MASK]);
+    });
+    bench.run("Mat4 transformPoint", [&](long long i) { vecOut[i & MASK] = mats[i & MASK].transformPoint(vecs[i & MASK]); });
+    bench.run("Mat4 inverse", [&](long long i) { matOut[i & MASK] = mats[i & MASK].inverse(); });
+    bench.run("Mat4 lookAt", [&](long long i) {
+        matOut[i & MASK] = Mat4::lookAt(vecs[i & MASK], vecs[(i + 7) & MASK], Vec3(0.0f, 1.0f, 0.0f));
+    });
+    bench.run("Mat4 perspective", [&](long long i) {
+        matOut[i & MASK] = Mat4::perspective(0.5f + 0.01f * (i & MASK), 16.0f / 9.0f, 0.1f, 200.0f);
+    });
+    bench.run("Vec3 normalize", [&](long long i) { vecOut[i & MASK] = vecs[i & MASK].normalize(); });
+    doNotOptimize(matOut);
+    doNotOptimize(legacyOut);
+    doNotOptimize(vecOut);
+
+    // Tra cứu location uniform của Shader: hash literal lúc biên dịch + bảng băm phẳng
+    UniformCache uniforms;
+    const UniformName names[] = { "model", "view", "projection", "normalMatrix", "lightPos",
+                                  "viewPos", "lightColor", "shadingModel", "displayMode", "time" };
+    const int nameCount = (int)(sizeof(names) / sizeof(names[0]));
+    for (int i = 0; i < nameCount; ++i) uniforms.insert(names[i], i);
+    bench.run("UniformCache find", [&](long long i) {
+        int location = -1;
+        uniforms.find(names[i % nameCount], location);
+        doNotOptimize(location);
+    });
+
+    // --- Algorithms2D ---
+    bench.run("bresenhamLine short (8 px)", [&](long long i) {
+        int o = (int)(i & MASK);
+        vector<Vec3> line = Algorithms2D::bresenhamLine(o, o, o + 8, o + 3);
+        doNotOptimize(line.data());
+    });
+    bench.run("bresenhamLine long (200 px)", [&](long long i) {
+        int o = (int)(i & MASK);
+        vector<Vec3> line = Algorithms2D::bresenhamLine(0, o, 199, 199 - o);
+        doNotOptimize(line.data());
+    });
+    // Ba trường hợp điển hình: nằm trong, nằm ngoài hẳn, cắt biên khung minimap
+    bench.run("cohenSutherlandClip", [&](long long i) {
+        double o = (double)(i & MASK);
+        double x0 = 1070.0 + o, y0 = 10.0, x1 = 1300.0 - o, y1 = 250.0 - o;
+        bool accept = Algorithms2D::cohenSutherlandClip(x0, y0, x1, y1, 1070.0, 1270.0, 10.0, 210.0);
+        doNotOptimize(accept);
+        doNotOptimize(x1);
+    });
+
+    // --- Terrain ---
+    const int sizes[] = { 50, 128, 256 };
+    for (int size : sizes) {
+        string suffix = " " + to_string(size) + "x" + to_string(size);
+        bench.run("Terrain generate" + suffix, [&](long long) {
+            Terrain terrain(size, size);
+            doNotOptimize(terrain.vertices.data());
+        });
+    }
+    Terrain terrain(50, 50);
+    bench.run("Terrain bakeAmbientOcclusion 50x50", [&](long long) {
+        terrain.bakeAmbientOcclusion();
+        doNotOptimize(terrain.ambientOcclusion.data());
+    });
+    HorizonMap horizonMap;
+    bench.run("HorizonMap build 50x50", [&](long long) {
+        horizonMap.build(terrain);
+        doNotOptimize(horizonMap.texels.data());
+    });
+
+    // --- Frustum culling: lưới 224x224 chunk (~50k), camera mặc định ---
+    Frustum frustum(Mat4::perspective(45.0f * PI / 180.0f, 16.0f / 9.0f, 0.1f, 200.0f),
+                    Mat4::lookAt(Vec3(15.0f, 8.0f, 35.0f), Vec3(0.0f, 0.0f, 0.0f), Vec3(0.0f, 1.0f, 0.0f)));
+    SphereBatch spheres;
+    AabbBatch boxes;
+    const int grid = 224;
+    for (int z = 0; z < grid; ++z) {
+        for (int x = 0; x < grid; ++x) {
+            Vec3 c(x * 2.2f - 250.0f, 0.0f, z * 2.2f - 250.0f);
+            spheres.add(c, 1.6f);
+            boxes.add(c - Vec3(1.1f, 4.0f, 1.1f), c + Vec3(1.1f, 4.0f, 1.1f));
+        }
+    }
+    if (!checkCullAgainstScalar(frustum, spheres, boxes)) return 2;
+    vector<uint32_t> visible;
+    bench.run("Frustum cullSpheres 50k (x4)", [&](long long) { doNotOptimize(frustum.cullSpheres<f32x4>(spheres, visible)); });
+    bench.run("Frustum cullSpheres 50k (x8)", [&](long long) { doNotOptimize(frustum.cullSpheres<f32x8>(spheres, visible)); });
+    bench.run("Frustum cullAabbs 50k (x8)", [&](long long) { doNotOptimize(frustum.cullAabbs<f32x8>(boxes, visible)); });
+
+    // Chi phí một PROFILE_ZONE khi tắt (mặc định) và khi bật (ghi vào ring buffer của luồng)
+    bench.run("Profiler zone (disabled)", [&](long long i) {
+        PROFILE_ZONE("bench");
+        doNotOptimize(i);
+    });
+    Profiler::enable(true);
+    bench.run("Profiler zone (enabled)", [&](long long i) {
+        PROFILE_ZONE("bench");
+        doNotOptimize(i);
+    });
+    Profiler::enable(false);
+
+    if (json) bench.writeJson(stdout);
+    else bench.printTable(stdout);
+    return 0;
+}
@@ -0,0 +1,31 @@
+# Sinh header chứa mã nguồn GLSL trong assets/ dưới dạng constexpr,
+# để Shader không phải đọc file (và không phụ thuộc thư mục làm việc) lúc khởi động
+# Dùng: cmake -DSOURCE_DIR=<thư mục project> -DOUTPUT=<file header> -P EmbedShaders.cmake
+
+file(GLOB shaders RELATIVE "${SOURCE_DIR}" "${SOURCE_DIR}/assets/*.vert" "${SOURCE_DIR}/assets/*.frag"
+     "${SOURCE_DIR}/assets/*.glsl")
+list(SORT shaders)
+
+set(entries "")
+foreach(path ${shaders})
+    file(READ "${SOURCE_DIR}/${path}" glsl)
+    string(FIND "${glsl}" ")GLSL\"" clash)
+    if(NOT clash EQUAL -1)
+        message(FATAL_ERROR "${path} contains the raw string delimiter )GLSL\"")
+    endif()
+    string(APPEND entries "    { \"${path}\", R\"GLSL(${glsl})GLSL\" },\n")
+endforeach()
+
+set(content "// File sinh tự động bởi cmake/EmbedShaders.cmake - không sửa tay\n")
+string(APPEND content "#ifndef EMBEDDED_SHADERS_H\n#define EMBEDDED_SHADERS_H\n\n")
+string(APPEND content "struct EmbeddedShader {\n    const char* path;   // Đường dẫn tương đối, ví dụ \"assets/terrain.vert\"\n    const char* source;\n};\n\n")
+string(APPEND content "constexpr EmbeddedShader EMBEDDED_SHADERS[] = {\n${entries}};\n\n#endif\n")
+
+# Chỉ ghi khi nội dung đổi để không kéo theo biên dịch lại không cần thiết
+if(EXISTS "${OUTPUT}")
+    file(READ "${OUTPUT}" previous)
+    if(previous STREQUAL content)
+        return()
+    endif()
+endif()
+file(WRITE "${OUTPUT}" "${content}")
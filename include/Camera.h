@@ -42,6 +42,15 @@ public:
         updateCameraVectors();
     }
 
+    // Đặt hướng nhìn trực tiếp (độ), dùng cho đường bay dựng sẵn
+    void setOrientation(float newYaw, float newPitch) {
+        yaw = newYaw;
+        pitch = newPitch;
+        if (pitch > 89.0f) pitch = 89.0f;
+        if (pitch < -89.0f) pitch = -89.0f;
+        updateCameraVectors();
+    }
+
 private:
     void updateCameraVectors() {
         Vec3 frontNew;
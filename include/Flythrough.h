@@ -0,0 +1,26 @@
+#ifndef FLYTHROUGH_H
+#define FLYTHROUGH_H
+
+#include <cmath>
+#include "Camera.h"
+#include "Math3D.h"
+
+// Đường bay camera cố định cho chế độ --bench: chỉ phụ thuộc số frame, không phụ thuộc thời gian thực
+// hay input, nên mọi lần chạy (mọi máy) vẽ đúng cùng một chuỗi khung hình
+class Flythrough {
+public:
+    // Một vòng quanh đảo, cao độ và bán kính dao động, luôn nhìn về gần tâm terrain
+    static void apply(Camera& camera, int frame, int frameCount) {
+        float t = frameCount > 1 ? (float)frame / (float)(frameCount - 1) : 0.0f;
+        float angle = 2.0f * PI * t;
+        float radius = 32.0f + 8.0f * sin(3.0f * angle);
+        float height = 10.0f + 5.0f * sin(2.0f * angle);
+        camera.position = Vec3(radius * cos(angle), height, radius * sin(angle));
+
+        Vec3 target(4.0f * sin(angle), 2.0f, 4.0f * cos(angle));
+        Vec3 dir = (target - camera.position).normalize();
+        camera.setOrientation(atan2(dir.z, dir.x) * 180.0f / PI, asin(dir.y) * 180.0f / PI);
+    }
+};
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef FRAME_UNIFORMS_H
+#define FRAME_UNIFORMS_H
+
+#include <glad/glad.h>
+#include <cstddef>
+using namespace std;
+
+#include "Math3D.h"
+
+// Khớp từng byte với block "FrameData" (std140) trong terrain/water shader:
+// mat4 chiếm 64 byte, vec3 căn 16 byte, float được xếp vào 4 byte trống sau vec3
+struct FrameData {
+    Mat4 view;
+    Mat4 projection;
+    Vec3 viewPos;    float pad0;
+    Vec3 lightPos;   float pad1;
+    Vec3 lightColor; float time;
+};
+
+static_assert(offsetof(FrameData, projection) == 64, "std140: projection at 64");
+static_assert(offsetof(FrameData, viewPos) == 128, "std140: viewPos at 128");
+static_assert(offsetof(FrameData, lightPos) == 144, "std140: lightPos at 144");
+static_assert(offsetof(FrameData, lightColor) == 160, "std140: lightColor at 160");
+static_assert(offsetof(FrameData, time) == 172, "std140: time packs after lightColor");
+static_assert(sizeof(FrameData) == 176, "std140: FrameData is 176 bytes");
+
+//  Uniform buffer dùng chung cho mọi program: ghi một lần mỗi frame
+// Mỗi lần update gọi glBufferData với dữ liệu mới (orphaning): driver cấp vùng nhớ mới
+// thay vì chờ GPU đọc xong frame trước, nên CPU không bị chặn
+class FrameUniformBuffer {
+public:
+    static const unsigned int BINDING = 0; // Binding point của block FrameData
+    static constexpr const char* BLOCK_NAME = "FrameData";
+
+    unsigned int ID = 0;
+
+    void create() {
+        glGenBuffers(1, &ID);
+        glBindBuffer(GL_UNIFORM_BUFFER, ID);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameData), NULL, GL_STREAM_DRAW);
+        glBindBufferBase(GL_UNIFORM_BUFFER, BINDING, ID);
+    }
+
+    void update(const FrameData& data) {
+        glBindBuffer(GL_UNIFORM_BUFFER, ID);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameData), &data, GL_STREAM_DRAW);
+    }
+
+    void destroy() {
+        if (ID) glDeleteBuffers(1, &ID);
+        ID = 0;
+    }
+};
+
+#endif
@@ -0,0 +1,199 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <cstdint>
+#include <vector>
+using namespace std;
+
+#include "Math3D.h"
+#include "Simd.h"
+
+//  Mảng hình cầu bao dạng SoA (tâm + bán kính) cho cull theo lô
+struct SphereBatch {
+    vector<float> cx, cy, cz, radius;
+
+    size_t size() const { return cx.size(); }
+    void clear() { cx.clear(); cy.clear(); cz.clear(); radius.clear(); }
+    void reserve(size_t n) { cx.reserve(n); cy.reserve(n); cz.reserve(n); radius.reserve(n); }
+    void add(const Vec3& center, float r) {
+        cx.push_back(center.x); cy.push_back(center.y); cz.push_back(center.z);
+        radius.push_back(r);
+    }
+};
+
+//  Mảng AABB dạng SoA, lưu tâm + nửa kích thước (extent) để test plane rẻ hơn min/max
+struct AabbBatch {
+    vector<float> cx, cy, cz, ex, ey, ez;
+
+    size_t size() const { return cx.size(); }
+    void clear() { cx.clear(); cy.clear(); cz.clear(); ex.clear(); ey.clear(); ez.clear(); }
+    void reserve(size_t n) {
+        cx.reserve(n); cy.reserve(n); cz.reserve(n);
+        ex.reserve(n); ey.reserve(n); ez.reserve(n);
+    }
+    void add(const Vec3& minCorner, const Vec3& maxCorner) {
+        Vec3 c = (minCorner + maxCorner) * 0.5f;
+        Vec3 e = (maxCorner - minCorner) * 0.5f;
+        cx.push_back(c.x); cy.push_back(c.y); cz.push_back(c.z);
+        ex.push_back(e.x); ey.push_back(e.y); ez.push_back(e.z);
+    }
+};
+
+//  Thể tích nhìn (View Frustum) - 6 mặt phẳng trích từ ma trận clip (Gribb-Hartmann)
+// Mặt phẳng lưu (nx, ny, nz, d), pháp tuyến hướng vào trong: điểm p ở trong khi n.p + d >= 0
+class Frustum {
+public:
+    enum { LEFT, RIGHT, BOTTOM, TOP, NEAR_PLANE, FAR_PLANE, PLANE_COUNT };
+
+    Vec4 planes[PLANE_COUNT];
+
+    Frustum() : planes{} {}
+
+    // Mat4 a * b tương ứng b·a trong GLSL, nên clip = projection·view trong shader là view * projection
+    Frustum(const Mat4& projection, const Mat4& view) { extract(view * projection); }
+
+    static Frustum fromClip(const Mat4& clip) {
+        Frustum f;
+        f.extract(clip);
+        return f;
+    }
+
+    // Test đơn lẻ: true nếu giao hoặc nằm trong frustum
+    bool testSphere(const Vec3& center, float radius) const {
+        for (int i = 0; i < PLANE_COUNT; ++i) {
+            const Vec4& p = planes[i];
+            if (p.x * center.x + p.y * center.y + p.z * center.z + p.w < -radius) return false;
+        }
+        return true;
+    }
+
+    bool testAabb(const Vec3& minCorner, const Vec3& maxCorner) const {
+        Vec3 c = (minCorner + maxCorner) * 0.5f;
+        Vec3 e = (maxCorner - minCorner) * 0.5f;
+        for (int i = 0; i < PLANE_COUNT; ++i) {
+            const Vec4& p = planes[i];
+            // Bán kính chiếu của hộp lên pháp tuyến
+            float r = fabs(p.x) * e.x + fabs(p.y) * e.y + fabs(p.z) * e.z;
+            if (p.x * c.x + p.y * c.y + p.z * c.z + p.w < -r) return false;
+        }
+        return true;
+    }
+
+    // Cull theo lô: ghi chỉ số các phần tử nhìn thấy (tăng dần) vào visible, trả về số lượng
+    // (chưa có caller trong main.cpp - terrain là một mesh, dùng testAabb; benchmark đo đường này)
+    // F = f32x4 hoặc f32x8; mặc định dùng độ rộng lớn nhất mà CPU hỗ trợ
+    template <typename F = f32x8>
+    size_t cullSpheres(const SphereBatch& batch, vector<uint32_t>& visible) const {
+        const size_t n = batch.size();
+        visible.resize(n);
+        uint32_t* out = visible.data();
+        size_t count = 0;
+
+        PlaneLanes<F> pl(*this);
+        size_t i = 0;
+        for (; i + F::LANES <= n; i += F::LANES) {
+            F x = F::loadu(&batch.cx[i]), y = F::loadu(&batch.cy[i]), z = F::loadu(&batch.cz[i]);
+            F r = F::loadu(&batch.radius[i]);
+            // Khoảng cách có dấu nhỏ nhất tới 6 mặt, cộng bán kính: âm nghĩa là nằm ngoài.
+            // Hai mặt bên loại phần lớn lô trước, cả lô đã ngoài thì bỏ 4 mặt còn lại
+            F dist = min(pl.nx[LEFT] * x + pl.ny[LEFT] * y + pl.nz[LEFT] * z + pl.d[LEFT],
+                         pl.nx[RIGHT] * x + pl.ny[RIGHT] * y + pl.nz[RIGHT] * z + pl.d[RIGHT]);
+            if (signMask(dist + r) == ALL_OUTSIDE<F>) continue;
+            for (int p = BOTTOM; p < PLANE_COUNT; ++p)
+                dist = min(dist, pl.nx[p] * x + pl.ny[p] * y + pl.nz[p] * z + pl.d[p]);
+            count = compact(signMask(dist + r), (uint32_t)i, F::LANES, out, count);
+        }
+        for (; i < n; ++i) {
+            out[count] = (uint32_t)i;
+            count += testSphere(Vec3(batch.cx[i], batch.cy[i], batch.cz[i]), batch.radius[i]) ? 1 : 0;
+        }
+
+        visible.resize(count);
+        return count;
+    }
+
+    template <typename F = f32x8>
+    size_t cullAabbs(const AabbBatch& batch, vector<uint32_t>& visible) const {
+        const size_t n = batch.size();
+        visible.resize(n);
+        uint32_t* out = visible.data();
+        size_t count = 0;
+
+        PlaneLanes<F> pl(*this);
+        size_t i = 0;
+        for (; i + F::LANES <= n; i += F::LANES) {
+            F x = F::loadu(&batch.cx[i]), y = F::loadu(&batch.cy[i]), z = F::loadu(&batch.cz[i]);
+            F ex = F::loadu(&batch.ex[i]), ey = F::loadu(&batch.ey[i]), ez = F::loadu(&batch.ez[i]);
+            // Hộp ngoài frustum khi tồn tại mặt mà n.c + d + |n|.e < 0 (hai mặt bên trước, như cullSpheres)
+            F dist = min(pl.nx[LEFT] * x + pl.ny[LEFT] * y + pl.nz[LEFT] * z + pl.d[LEFT]
+                             + pl.ax[LEFT] * ex + pl.ay[LEFT] * ey + pl.az[LEFT] * ez,
+                         pl.nx[RIGHT] * x + pl.ny[RIGHT] * y + pl.nz[RIGHT] * z + pl.d[RIGHT]
+                             + pl.ax[RIGHT] * ex + pl.ay[RIGHT] * ey + pl.az[RIGHT] * ez);
+            if (signMask(dist) == ALL_OUTSIDE<F>) continue;
+            for (int p = BOTTOM; p < PLANE_COUNT; ++p)
+                dist = min(dist, pl.nx[p] * x + pl.ny[p] * y + pl.nz[p] * z + pl.d[p]
+                               + pl.ax[p] * ex + pl.ay[p] * ey + pl.az[p] * ez);
+            count = compact(signMask(dist), (uint32_t)i, F::LANES, out, count);
+        }
+        for (; i < n; ++i) {
+            Vec3 c(batch.cx[i], batch.cy[i], batch.cz[i]);
+            Vec3 e(batch.ex[i], batch.ey[i], batch.ez[i]);
+            out[count] = (uint32_t)i;
+            count += testAabb(c - e, c + e) ? 1 : 0;
+        }
+
+        visible.resize(count);
+        return count;
+    }
+
+private:
+    template <typename F>
+    static constexpr int ALL_OUTSIDE = (1 << F::LANES) - 1;
+
+    // Hệ số mặt phẳng broadcast sẵn ra các làn, tính một lần mỗi lần cull
+    template <typename F>
+    struct PlaneLanes {
+        F nx[PLANE_COUNT], ny[PLANE_COUNT], nz[PLANE_COUNT], d[PLANE_COUNT];
+        F ax[PLANE_COUNT], ay[PLANE_COUNT], az[PLANE_COUNT]; // |n| cho AABB
+        explicit PlaneLanes(const Frustum& f) {
+            for (int p = 0; p < PLANE_COUNT; ++p) {
+                const Vec4& pl = f.planes[p];
+                nx[p] = F(pl.x); ny[p] = F(pl.y); nz[p] = F(pl.z); d[p] = F(pl.w);
+                ax[p] = F(fabs(pl.x)); ay[p] = F(fabs(pl.y)); az[p] = F(fabs(pl.z));
+            }
+        }
+    };
+
+    // Ghi không rẽ nhánh: luôn ghi chỉ số, chỉ tăng count khi làn nhìn thấy (bit dấu = 0)
+    static size_t compact(int outsideMask, uint32_t base, int lanes, uint32_t* out, size_t count) {
+        for (int l = 0; l < lanes; ++l) {
+            out[count] = base + l;
+            count += ((outsideMask >> l) & 1) ^ 1;
+        }
+        return count;
+    }
+
+    // Hàng r của ma trận theo nghĩa GLSL = (m[0][r], m[1][r], m[2][r], m[3][r])
+    void extract(const Mat4& clip) {
+        Vec4 row[4];
+        for (int r = 0; r < 4; ++r)
+            row[r] = Vec4{ clip.m[0][r], clip.m[1][r], clip.m[2][r], clip.m[3][r] };
+
+        planes[LEFT]       = combine(row[3], row[0],  1.0f);
+        planes[RIGHT]      = combine(row[3], row[0], -1.0f);
+        planes[BOTTOM]     = combine(row[3], row[1],  1.0f);
+        planes[TOP]        = combine(row[3], row[1], -1.0f);
+        planes[NEAR_PLANE] = combine(row[3], row[2],  1.0f);
+        planes[FAR_PLANE]  = combine(row[3], row[2], -1.0f);
+    }
+
+    // row3 +/- rowK, chuẩn hoá để d là khoảng cách thật (bán kính cầu so sánh trực tiếp)
+    static Vec4 combine(const Vec4& w, const Vec4& k, float sign) {
+        Vec4 p{ w.x + sign * k.x, w.y + sign * k.y, w.z + sign * k.z, w.w + sign * k.w };
+        float len = sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+        if (len > 0.0f) { p.x /= len; p.y /= len; p.z /= len; p.w /= len; }
+        return p;
+    }
+};
+
+#endif
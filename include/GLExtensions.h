@@ -0,0 +1,128 @@
+#ifndef GL_EXTENSIONS_H
+#define GL_EXTENSIONS_H
+
+#include <glad/glad.h>
+#include <cstdlib>
+#include <cstring>
+using namespace std;
+
+// GLAD của project chỉ sinh cho OpenGL 3.3 core, không kèm extension nào.
+// Các hàm mới hơn (program binary, ...) được nạp tay ở đây khi driver hỗ trợ,
+// dùng lại đúng hàm loader đã đưa cho GLAD (glfwGetProcAddress, eglGetProcAddress...)
+
+// GL 4.1 / ARB_get_program_binary
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#define GL_PROGRAM_BINARY_FORMATS 0x87FF
+#endif
+
+// KHR_parallel_shader_compile / ARB_parallel_shader_compile
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+// GL 4.6 / ARB_pipeline_statistics_query (dùng chung glBeginQuery/glEndQuery của GL 3.3)
+#ifndef GL_VERTEX_SHADER_INVOCATIONS_ARB
+#define GL_VERTEX_SHADER_INVOCATIONS_ARB 0x82F0
+#define GL_FRAGMENT_SHADER_INVOCATIONS_ARB 0x82F4
+#endif
+
+// GL 4.4 / ARB_buffer_storage
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#define GL_CLIENT_STORAGE_BIT 0x0200
+#endif
+
+typedef void (APIENTRYP PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)(GLuint count);
+typedef void (APIENTRYP PFNGLGETPROGRAMBINARYPROC)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+typedef void (APIENTRYP PFNGLPROGRAMBINARYPROC)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+typedef void (APIENTRYP PFNGLPROGRAMPARAMETERIPROC)(GLuint program, GLenum pname, GLint value);
+typedef void (APIENTRYP PFNGLBUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+
+class GLExtensions {
+public:
+    // Program binary (GL 4.1 hoặc GL_ARB_get_program_binary, và driver có ít nhất 1 định dạng)
+    static inline bool programBinary = false;
+    static inline PFNGLGETPROGRAMBINARYPROC getProgramBinary = NULL;
+    static inline PFNGLPROGRAMBINARYPROC programBinaryLoad = NULL;
+    static inline PFNGLPROGRAMPARAMETERIPROC programParameteri = NULL;
+
+    // Compile shader song song trên luồng của driver; có thể hỏi GL_COMPLETION_STATUS_KHR không bị chặn
+    static inline bool parallelShaderCompile = false;
+    static inline PFNGLMAXSHADERCOMPILERTHREADSKHRPROC maxShaderCompilerThreads = NULL;
+
+    // Đếm số lần chạy vertex/fragment shader bằng query (GL 4.6 hoặc GL_ARB_pipeline_statistics_query)
+    static inline bool pipelineStatistics = false;
+
+    // Buffer bất biến, map một lần và giữ con trỏ suốt đời buffer (GL 4.4 hoặc GL_ARB_buffer_storage)
+    // Đặt biến môi trường TERRAIN_DISABLE_BUFFER_STORAGE để ép dùng đường GL 3.3
+    static inline bool bufferStorage = false;
+    static inline PFNGLBUFFERSTORAGEPROC bufferStorageAlloc = NULL;
+
+    // Gọi một lần sau gladLoadGLLoader, khi context đã current
+    static void load(GLADloadproc loader) {
+        loaderProc = loader;
+
+        programBinary = false;
+        getProgramBinary = NULL;
+        programBinaryLoad = NULL;
+        programParameteri = NULL;
+        maxShaderCompilerThreads = NULL;
+        if (hasVersion(4, 1) || has("GL_ARB_get_program_binary")) {
+            getProgramBinary = (PFNGLGETPROGRAMBINARYPROC)loader("glGetProgramBinary");
+            programBinaryLoad = (PFNGLPROGRAMBINARYPROC)loader("glProgramBinary");
+            programParameteri = (PFNGLPROGRAMPARAMETERIPROC)loader("glProgramParameteri");
+            GLint formats = 0;
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+            programBinary = getProgramBinary && programBinaryLoad && programParameteri && formats > 0;
+        }
+
+        parallelShaderCompile = false;
+        if (has("GL_KHR_parallel_shader_compile"))
+            maxShaderCompilerThreads = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)loader("glMaxShaderCompilerThreadsKHR");
+        else if (has("GL_ARB_parallel_shader_compile"))
+            maxShaderCompilerThreads = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)loader("glMaxShaderCompilerThreadsARB");
+        if (maxShaderCompilerThreads) {
+            maxShaderCompilerThreads(0xFFFFFFFFu); // Để driver tự chọn số luồng
+            parallelShaderCompile = true;
+        }
+
+        pipelineStatistics = hasVersion(4, 6) || has("GL_ARB_pipeline_statistics_query");
+
+        bufferStorage = false;
+        bufferStorageAlloc = NULL;
+        if (!getenv("TERRAIN_DISABLE_BUFFER_STORAGE") && (hasVersion(4, 4) || has("GL_ARB_buffer_storage")))
+            bufferStorageAlloc = (PFNGLBUFFERSTORAGEPROC)loader("glBufferStorage");
+        bufferStorage = bufferStorageAlloc != NULL;
+    }
+
+    static bool has(const char* name) {
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count; ++i) {
+            const char* ext = (const char*)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+            if (ext && strcmp(ext, name) == 0) return true;
+        }
+        return false;
+    }
+
+    static bool hasVersion(int major, int minor) {
+        GLint current[2] = { 0, 0 };
+        glGetIntegerv(GL_MAJOR_VERSION, &current[0]);
+        glGetIntegerv(GL_MINOR_VERSION, &current[1]);
+        return current[0] > major || (current[0] == major && current[1] >= minor);
+    }
+
+    // Nạp thêm hàm tuỳ ý bằng loader đã lưu (NULL nếu chưa load hoặc driver không có)
+    static void* proc(const char* name) { return loaderProc ? loaderProc(name) : NULL; }
+
+private:
+    static inline GLADloadproc loaderProc = NULL;
+};
+
+#endif
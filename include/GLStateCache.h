@@ -0,0 +1,159 @@
+#ifndef GL_STATE_CACHE_H
+#define GL_STATE_CACHE_H
+
+#include <glad/glad.h>
+#include <cstdint>
+using namespace std;
+
+// Lớp mỏng giữ bản sao trạng thái GL hiện tại và bỏ các lệnh đặt lại đúng giá trị đang có
+// Mọi thay đổi trạng thái trong vòng lặp render phải đi qua đây; code nào gọi gl* trực tiếp
+// (ví dụ Shader::use, setup sau hot-reload) thì gọi invalidate() để lần sau luôn phát lệnh thật
+class GLStateCache {
+public:
+    struct Stats {
+        uint32_t issued = 0;   // Lệnh thực sự gửi xuống driver
+        uint32_t filtered = 0; // Lệnh bị bỏ vì trạng thái không đổi
+    };
+
+    GLStateCache() { invalidate(); }
+
+    // Quên mọi giá trị đã biết - lệnh kế tiếp của mỗi loại luôn được phát
+    void invalidate() {
+        for (int i = 0; i < CAP_COUNT; ++i) capState[i] = UNKNOWN;
+        blendSrc = blendDst = INVALID;
+        polygonModeValue = INVALID;
+        lineWidthValue = pointSizeValue = -1.0f;
+        program = vertexArray = arrayBuffer = INVALID;
+        activeUnit = INVALID;
+        for (int i = 0; i < TEXTURE_UNITS; ++i) texture2D[i] = texture2DArray[i] = INVALID;
+    }
+
+    // Gọi đầu mỗi frame: chốt số liệu frame trước vào lastFrame
+    void beginFrame() {
+        lastFrame = current;
+        current = Stats();
+    }
+
+    const Stats& lastFrameStats() const { return lastFrame; }
+
+    void enable(GLenum cap) { setCapability(cap, true); }
+    void disable(GLenum cap) { setCapability(cap, false); }
+
+    void blendFunc(GLenum src, GLenum dst) {
+        if (blendSrc == src && blendDst == dst) return filter();
+        blendSrc = src;
+        blendDst = dst;
+        glBlendFunc(src, dst);
+        ++current.issued;
+    }
+
+    // Chỉ theo dõi GL_FRONT_AND_BACK (core profile không cho đặt riêng mặt trước/sau)
+    void polygonMode(GLenum mode) {
+        if (polygonModeValue == mode) return filter();
+        polygonModeValue = mode;
+        glPolygonMode(GL_FRONT_AND_BACK, mode);
+        ++current.issued;
+    }
+
+    void lineWidth(float width) {
+        if (lineWidthValue == width) return filter();
+        lineWidthValue = width;
+        glLineWidth(width);
+        ++current.issued;
+    }
+
+    void pointSize(float size) {
+        if (pointSizeValue == size) return filter();
+        pointSizeValue = size;
+        glPointSize(size);
+        ++current.issued;
+    }
+
+    void useProgram(GLuint id) {
+        if (program == id) return filter();
+        program = id;
+        glUseProgram(id);
+        ++current.issued;
+    }
+
+    // GL_ELEMENT_ARRAY_BUFFER thuộc trạng thái của VAO nên không cache ở đây
+    void bindVertexArray(GLuint id) {
+        if (vertexArray == id) return filter();
+        vertexArray = id;
+        glBindVertexArray(id);
+        ++current.issued;
+    }
+
+    void bindArrayBuffer(GLuint id) {
+        if (arrayBuffer == id) return filter();
+        arrayBuffer = id;
+        glBindBuffer(GL_ARRAY_BUFFER, id);
+        ++current.issued;
+    }
+
+    void activeTexture(GLenum unit) {
+        if (activeUnit == unit) return filter();
+        activeUnit = unit;
+        glActiveTexture(unit);
+        ++current.issued;
+    }
+
+    // Gắn texture vào unit đang active (GL_TEXTURE_2D hoặc GL_TEXTURE_2D_ARRAY)
+    void bindTexture(GLenum target, GLuint id) {
+        GLuint* slot = textureSlot(target);
+        if (slot && *slot == id) return filter();
+        if (slot) *slot = id;
+        glBindTexture(target, id);
+        ++current.issued;
+    }
+
+private:
+    static const GLuint INVALID = 0xFFFFFFFFu;
+    static const int8_t UNKNOWN = -1;
+    static const int TEXTURE_UNITS = 8;
+
+    enum { CAP_BLEND, CAP_DEPTH_TEST, CAP_CULL_FACE, CAP_COUNT };
+
+    int8_t capState[CAP_COUNT];
+    GLenum blendSrc, blendDst;
+    GLenum polygonModeValue;
+    float lineWidthValue, pointSizeValue;
+    GLuint program, vertexArray, arrayBuffer;
+    GLenum activeUnit;
+    GLuint texture2D[TEXTURE_UNITS], texture2DArray[TEXTURE_UNITS];
+    Stats current, lastFrame;
+
+    void filter() { ++current.filtered; }
+
+    static int capIndex(GLenum cap) {
+        switch (cap) {
+        case GL_BLEND: return CAP_BLEND;
+        case GL_DEPTH_TEST: return CAP_DEPTH_TEST;
+        case GL_CULL_FACE: return CAP_CULL_FACE;
+        default: return -1;
+        }
+    }
+
+    void setCapability(GLenum cap, bool on) {
+        int index = capIndex(cap);
+        if (index >= 0) {
+            if (capState[index] == (int8_t)on) return filter();
+            capState[index] = (int8_t)on;
+        }
+        if (on) glEnable(cap);
+        else glDisable(cap);
+        ++current.issued;
+    }
+
+    // Unit chưa biết hoặc ngoài phạm vi theo dõi -> không cache (luôn phát lệnh)
+    GLuint* textureSlot(GLenum target) {
+        if (activeUnit == INVALID) return nullptr;
+        GLuint unit = activeUnit - GL_TEXTURE0;
+        if (unit >= (GLuint)TEXTURE_UNITS) return nullptr;
+        if (target == GL_TEXTURE_2D) return &texture2D[unit];
+        if (target == GL_TEXTURE_2D_ARRAY) return &texture2DArray[unit];
+        return nullptr;
+    }
+};
+
+#endif
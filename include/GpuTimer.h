@@ -0,0 +1,155 @@
+#ifndef GPU_TIMER_H
+#define GPU_TIMER_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "GLExtensions.h"
+#include "Profiler.h"
+
+// Đo thời gian GPU của từng render pass bằng GL_TIME_ELAPSED (+ số lần chạy vertex/fragment shader nếu
+// driver có ARB_pipeline_statistics_query)
+// Query của mỗi frame nằm trong một ô của ring FRAMES_IN_FLIGHT ô; kết quả chỉ được đọc khi ô đó quay lại
+// và GL_QUERY_RESULT_AVAILABLE đã bật - không bao giờ chặn CPU chờ GPU. Kết quả chưa có thì bỏ mẫu đó.
+class GpuPassTimer {
+public:
+    static const int FRAMES_IN_FLIGHT = 4;
+    static const int AVERAGE_WINDOW = 60; // Số mẫu gần nhất tính trung bình
+
+    struct PassStats {
+        string name;
+        double gpuMs = 0.0;                // Trung bình trượt
+        double vertexInvocations = 0.0;    // Trung bình trượt, 0 nếu không có pipeline statistics
+        double fragmentInvocations = 0.0;
+        int samples = 0;                   // Số mẫu đang nằm trong cửa sổ trung bình
+    };
+
+    struct Stats {
+        vector<PassStats> passes;
+        bool pipelineStatistics = false;
+        uint64_t droppedSamples = 0; // Mẫu bị bỏ vì GPU chậm hơn FRAMES_IN_FLIGHT frame
+    };
+
+    // Gọi sau khi có context; trả về chỉ số pass theo thứ tự names
+    void create(const vector<string>& names) {
+        withStatistics = GLExtensions::pipelineStatistics;
+        stats = Stats();
+        stats.pipelineStatistics = withStatistics;
+        passes.assign(names.size(), Pass());
+        for (size_t p = 0; p < names.size(); ++p) {
+            stats.passes.push_back(PassStats());
+            stats.passes[p].name = names[p];
+            passes[p].counterName = "gpu " + names[p] + " (ms)";
+            for (int slot = 0; slot < FRAMES_IN_FLIGHT; ++slot) {
+                Slot& s = passes[p].slots[slot];
+                glGenQueries(withStatistics ? 3 : 1, s.queries);
+            }
+        }
+        frame = 0;
+    }
+
+    void destroy() {
+        for (Pass& pass : passes)
+            for (Slot& s : pass.slots) glDeleteQueries(withStatistics ? 3 : 1, s.queries);
+        passes.clear();
+    }
+
+    // Đầu mỗi frame: chuyển sang ô kế tiếp, đọc kết quả cũ của ô đó nếu GPU đã xong
+    void beginFrame() {
+        ++frame;
+        int slot = (int)(frame % FRAMES_IN_FLIGHT);
+        for (size_t p = 0; p < passes.size(); ++p) {
+            Slot& s = passes[p].slots[slot];
+            if (!s.issued) continue;
+            s.issued = false;
+            if (!available(s)) {
+                ++stats.droppedSamples;
+                continue;
+            }
+            GLuint64 values[3] = { 0, 0, 0 };
+            for (int q = 0; q < (withStatistics ? 3 : 1); ++q) glGetQueryObjectui64v(s.queries[q], GL_QUERY_RESULT, &values[q]);
+            addSample(p, values[0] / 1.0e6, (double)values[1], (double)values[2]);
+        }
+    }
+
+    void begin(int pass) {
+        Slot& s = passes[pass].slots[frame % FRAMES_IN_FLIGHT];
+        glBeginQuery(GL_TIME_ELAPSED, s.queries[0]);
+        if (withStatistics) {
+            glBeginQuery(GL_VERTEX_SHADER_INVOCATIONS_ARB, s.queries[1]);
+            glBeginQuery(GL_FRAGMENT_SHADER_INVOCATIONS_ARB, s.queries[2]);
+        }
+    }
+
+    void end(int pass) {
+        glEndQuery(GL_TIME_ELAPSED);
+        if (withStatistics) {
+            glEndQuery(GL_VERTEX_SHADER_INVOCATIONS_ARB);
+            glEndQuery(GL_FRAGMENT_SHADER_INVOCATIONS_ARB);
+        }
+        passes[pass].slots[frame % FRAMES_IN_FLIGHT].issued = true;
+    }
+
+    const Stats& getStats() const { return stats; }
+
+private:
+    struct Slot {
+        GLuint queries[3] = { 0, 0, 0 }; // time elapsed, vertex invocations, fragment invocations
+        bool issued = false;
+    };
+
+    // Cửa sổ mẫu gần nhất (ring) để tính trung bình trượt
+    struct Pass {
+        Slot slots[FRAMES_IN_FLIGHT];
+        string counterName;
+        double gpuMs[AVERAGE_WINDOW] = {};
+        double vertices[AVERAGE_WINDOW] = {};
+        double fragments[AVERAGE_WINDOW] = {};
+        double sumMs = 0.0, sumVertices = 0.0, sumFragments = 0.0;
+        int next = 0, count = 0;
+    };
+
+    vector<Pass> passes;
+    Stats stats;
+    bool withStatistics = false;
+    uint64_t frame = 0;
+
+    bool available(const Slot& s) const {
+        for (int q = 0; q < (withStatistics ? 3 : 1); ++q) {
+            GLint ready = 0;
+            glGetQueryObjectiv(s.queries[q], GL_QUERY_RESULT_AVAILABLE, &ready);
+            if (!ready) return false;
+        }
+        return true;
+    }
+
+    void addSample(size_t p, double ms, double vertexCount, double fragmentCount) {
+        Pass& pass = passes[p];
+        if (pass.count == AVERAGE_WINDOW) {
+            pass.sumMs -= pass.gpuMs[pass.next];
+            pass.sumVertices -= pass.vertices[pass.next];
+            pass.sumFragments -= pass.fragments[pass.next];
+        } else {
+            ++pass.count;
+        }
+        pass.gpuMs[pass.next] = ms;
+        pass.vertices[pass.next] = vertexCount;
+        pass.fragments[pass.next] = fragmentCount;
+        pass.sumMs += ms;
+        pass.sumVertices += vertexCount;
+        pass.sumFragments += fragmentCount;
+        pass.next = (pass.next + 1) % AVERAGE_WINDOW;
+
+        PassStats& out = stats.passes[p];
+        out.gpuMs = pass.sumMs / pass.count;
+        out.vertexInvocations = pass.sumVertices / pass.count;
+        out.fragmentInvocations = pass.sumFragments / pass.count;
+        out.samples = pass.count;
+        Profiler::counter(pass.counterName.c_str(), ms);
+    }
+};
+
+#endif
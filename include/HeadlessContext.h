@@ -0,0 +1,98 @@
+#ifndef HEADLESS_CONTEXT_H
+#define HEADLESS_CONTEXT_H
+
+#include <cstdlib>
+#include <cstring>
+using namespace std;
+
+#include "Logger.h"
+
+// TERRAIN_HEADLESS do CMake bật khi tìm thấy EGL
+#if defined(TERRAIN_HEADLESS)
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+// Context OpenGL 3.3 core không cần cửa sổ: EGL pbuffer cỡ width x height làm framebuffer mặc định
+// Chạy được trên máy không GPU/không màn hình với Mesa llvmpipe
+class HeadlessContext {
+public:
+    HeadlessContext() = default;
+    HeadlessContext(const HeadlessContext&) = delete;
+    HeadlessContext& operator=(const HeadlessContext&) = delete;
+    ~HeadlessContext() { destroy(); }
+
+    bool create(int width, int height) {
+        display = openDisplay();
+        if (display == EGL_NO_DISPLAY || !eglInitialize(display, NULL, NULL)) {
+            LOG_ERROR("ERROR::HEADLESS::NO_EGL_DISPLAY");
+            display = EGL_NO_DISPLAY;
+            return false;
+        }
+        if (!eglBindAPI(EGL_OPENGL_API)) {
+            LOG_ERROR("ERROR::HEADLESS::OPENGL_API_UNSUPPORTED");
+            return false;
+        }
+
+        const EGLint configAttribs[] = {
+            EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+            EGL_DEPTH_SIZE, 24,
+            EGL_NONE
+        };
+        EGLConfig config;
+        EGLint configCount = 0;
+        if (!eglChooseConfig(display, configAttribs, &config, 1, &configCount) || configCount == 0) {
+            LOG_ERROR("ERROR::HEADLESS::NO_PBUFFER_CONFIG");
+            return false;
+        }
+
+        const EGLint surfaceAttribs[] = { EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE };
+        surface = eglCreatePbufferSurface(display, config, surfaceAttribs);
+        const EGLint contextAttribs[] = {
+            EGL_CONTEXT_MAJOR_VERSION, 3,
+            EGL_CONTEXT_MINOR_VERSION, 3,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_NONE
+        };
+        context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttribs);
+        if (surface == EGL_NO_SURFACE || context == EGL_NO_CONTEXT ||
+            !eglMakeCurrent(display, surface, surface, context)) {
+            LOG_ERROR("ERROR::HEADLESS::CONTEXT_CREATION_FAILED: 0x" << hex << eglGetError() << dec);
+            return false;
+        }
+        return true;
+    }
+
+    static void* procAddress(const char* name) { return (void*)eglGetProcAddress(name); }
+
+    void destroy() {
+        if (display == EGL_NO_DISPLAY) return;
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (context != EGL_NO_CONTEXT) eglDestroyContext(display, context);
+        if (surface != EGL_NO_SURFACE) eglDestroySurface(display, surface);
+        eglTerminate(display);
+        display = EGL_NO_DISPLAY;
+        context = EGL_NO_CONTEXT;
+        surface = EGL_NO_SURFACE;
+    }
+
+private:
+    EGLDisplay display = EGL_NO_DISPLAY;
+    EGLContext context = EGL_NO_CONTEXT;
+    EGLSurface surface = EGL_NO_SURFACE;
+
+    // Mesa: dùng platform surfaceless (không cần X11/Wayland) trừ khi người dùng chọn qua EGL_PLATFORM
+    static EGLDisplay openDisplay() {
+        const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+        if (!getenv("EGL_PLATFORM") && clientExtensions && strstr(clientExtensions, "EGL_MESA_platform_surfaceless")) {
+            PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+                (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+            if (getPlatformDisplay) return getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+        }
+        return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+};
+#endif
+
+#endif
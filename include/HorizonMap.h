@@ -0,0 +1,76 @@
+#ifndef HORIZON_MAP_H
+#define HORIZON_MAP_H
+
+#include <vector>
+using namespace std;
+
+#include "Math3D.h"
+#include "Parallel.h"
+#include "Simd.h"
+#include "Terrain.h"
+
+// Horizon map cho bóng đổ tự thân của địa hình
+// Với mỗi texel (đỉnh lưới) lưu góc chân trời theo DIRECTIONS hướng phương vị.
+// Fragment bị che khi góc ngẩng của ánh sáng thấp hơn góc chân trời theo hướng tới nguồn sáng.
+class HorizonMap {
+public:
+    static const int DIRECTIONS = 8;              // Hướng k có phương vị k * 45 độ trong mặt phẳng xz
+    static const int LAYERS = DIRECTIONS / 4;     // Mỗi layer RGBA8 chứa 4 hướng
+    static const int MAX_STEPS = 32;              // Khoảng quét tối đa (ô lưới)
+
+    int width = 0, height = 0;
+    // Layout: [layer][z][x][RGBA], góc chân trời chuẩn hoá 0..255 ứng với 0..90 độ
+    vector<unsigned char> texels;
+
+    size_t memoryBytes() const { return texels.size(); }
+
+    // Quét song song theo hàng, mỗi lần 4 texel liền nhau cùng một hướng (SIMD)
+    void build(const Terrain& terrain) {
+        width = terrain.width;
+        height = terrain.height;
+        texels.assign((size_t)LAYERS * width * height * 4, 0);
+
+        // Heightmap có viền MAX_STEPS ô mỗi phía, viền rất thấp nên không bao giờ che
+        // -> vòng quét không cần kiểm tra biên và 4 làn luôn đọc liền nhau
+        const int pad = MAX_STEPS;
+        const int pw = width + 2 * pad + 4;
+        const int ph = height + 2 * pad;
+        vector<float> padded((size_t)pw * ph, -1.0e6f);
+        for (int z = 0; z < height; ++z)
+            for (int x = 0; x < width; ++x)
+                padded[(size_t)(z + pad) * pw + x + pad] = terrain.heightAt(x, z);
+
+        static const int stepX[DIRECTIONS] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+        static const int stepZ[DIRECTIONS] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+
+        parallelFor(0, height, [&](int zBegin, int zEnd) {
+            float slopes[4];
+            for (int z = zBegin; z < zEnd; ++z) {
+                for (int d = 0; d < DIRECTIONS; ++d) {
+                    int offset = stepZ[d] * pw + stepX[d];
+                    float stepLength = sqrt((float)(stepX[d] * stepX[d] + stepZ[d] * stepZ[d]));
+                    unsigned char* out = &texels[((size_t)(d / 4) * height + z) * width * 4 + (d % 4)];
+
+                    for (int x = 0; x < width; x += 4) {
+                        const float* origin = &padded[(size_t)(z + pad) * pw + x + pad];
+                        f32x4 h0 = f32x4::loadu(origin);
+                        f32x4 maxSlope(0.0f);
+                        for (int s = 1; s <= MAX_STEPS; ++s) {
+                            f32x4 hs = f32x4::loadu(origin + s * offset);
+                            maxSlope = max(maxSlope, (hs - h0) * f32x4(1.0f / (s * stepLength)));
+                        }
+                        maxSlope.storeu(slopes);
+
+                        int lanes = min(4, width - x);
+                        for (int i = 0; i < lanes; ++i) {
+                            float angle = atan(slopes[i]) / (PI * 0.5f);
+                            out[(x + i) * 4] = (unsigned char)(angle * 255.0f + 0.5f);
+                        }
+                    }
+                }
+            }
+        });
+    }
+};
+
+#endif
@@ -0,0 +1,213 @@
+#ifndef HUD_H
+#define HUD_H
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+using namespace std;
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+#include "GLStateCache.h"
+#include "HudFont.h"
+#include "Math3D.h"
+#include "Shader.h"
+#include "StreamingAllocator.h"
+
+// Lớp phủ HUD: chữ (font bitmap nhúng sẵn) + hình chữ nhật (nền, đồ thị frame time)
+// Mọi quad của một frame gom lại, cấp phát một lần từ StreamingAllocator và vẽ bằng đúng một draw call
+// Toạ độ theo pixel, gốc ở góc dưới bên trái (cùng phép chiếu UI_ORTHO với minimap)
+class Hud {
+public:
+    static const int HISTORY = 120; // Số frame gần nhất trên đồ thị
+    static const int MEMORY_SAMPLE_FRAMES = 30;
+    static const int ATLAS_COLUMNS = 16;
+    static const int CELL_WIDTH = HudFont::GLYPH_WIDTH + 1; // 1 pixel đệm tránh lem sang glyph bên cạnh
+    static const int CELL_HEIGHT = HudFont::GLYPH_HEIGHT + 1;
+    static const int ATLAS_WIDTH = ATLAS_COLUMNS * CELL_WIDTH;
+    static const int ATLAS_HEIGHT = (HudFont::COUNT / ATLAS_COLUMNS) * CELL_HEIGHT;
+
+    struct Vertex {
+        float x, y;
+        float u, v;
+        uint8_t r, g, b, a;
+    };
+
+    unsigned int atlasTexture = 0;
+
+    // Gọi sau khi có context: dựng atlas R8 từ bảng font, tạo VAO trỏ vào buffer của stream (vertex động)
+    void create(const StreamingAllocator& stream) {
+        vector<uint8_t> atlas(ATLAS_WIDTH * ATLAS_HEIGHT, 0);
+        for (int glyph = 0; glyph < HudFont::COUNT; ++glyph) {
+            int cellX = (glyph % ATLAS_COLUMNS) * CELL_WIDTH;
+            int cellY = (glyph / ATLAS_COLUMNS) * CELL_HEIGHT;
+            for (int y = 0; y < HudFont::GLYPH_HEIGHT; ++y)
+                for (int x = 0; x < HudFont::GLYPH_WIDTH; ++x)
+                    if (HudFont::pixel(glyph, x, y)) atlas[(cellY + y) * ATLAS_WIDTH + cellX + x] = 255;
+        }
+
+        glGenTextures(1, &atlasTexture);
+        glBindTexture(GL_TEXTURE_2D, atlasTexture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, ATLAS_WIDTH, ATLAS_HEIGHT, 0, GL_RED, GL_UNSIGNED_BYTE, &atlas[0]);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        glGenVertexArrays(1, &vao);
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, stream.buffer());
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, x));
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, u));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), (void*)offsetof(Vertex, r));
+        glEnableVertexAttribArray(2);
+        vertices.reserve(6 * 1024);
+    }
+
+    void destroy() {
+        glDeleteTextures(1, &atlasTexture);
+        glDeleteVertexArrays(1, &vao);
+        atlasTexture = vao = 0;
+    }
+
+    void addFrameTime(float ms) {
+        history[historyNext] = ms;
+        historyNext = (historyNext + 1) % HISTORY;
+        if (historyCount < HISTORY) ++historyCount;
+    }
+
+    // Trung bình frame time (ms) trên cửa sổ HISTORY
+    float averageFrameMs() const {
+        float sum = 0.0f;
+        for (int i = 0; i < historyCount; ++i) sum += history[i];
+        return historyCount ? sum / historyCount : 0.0f;
+    }
+
+    // Bắt đầu dựng frame HUD mới
+    void begin() { vertices.clear(); }
+
+    // rgba: 0xRRGGBBAA
+    void rect(float x, float y, float w, float h, uint32_t rgba) {
+        float u = solidU(), v = solidV();
+        quad(x, y, x + w, y + h, u, v, u, v, rgba);
+    }
+
+    // Vẽ chuỗi ASCII, (x, y) là góc dưới bên trái dòng chữ; trả về x sau ký tự cuối
+    float text(float x, float y, const char* s, uint32_t rgba, float scale = 2.0f) {
+        for (; *s; ++s) {
+            int glyph = (unsigned char)*s - HudFont::FIRST;
+            if (glyph < 0 || glyph >= HudFont::COUNT) glyph = '?' - HudFont::FIRST;
+            if (glyph != 0) {
+                float u0 = (float)((glyph % ATLAS_COLUMNS) * CELL_WIDTH) / ATLAS_WIDTH;
+                float v0 = (float)((glyph / ATLAS_COLUMNS) * CELL_HEIGHT) / ATLAS_HEIGHT;
+                float u1 = u0 + (float)HudFont::GLYPH_WIDTH / ATLAS_WIDTH;
+                float v1 = v0 + (float)HudFont::GLYPH_HEIGHT / ATLAS_HEIGHT;
+                // Hàng 0 của glyph ở trên cùng -> v0 ứng với cạnh trên của quad
+                quad(x, y, x + HudFont::GLYPH_WIDTH * scale, y + HudFont::GLYPH_HEIGHT * scale, u0, v1, u1, v0, rgba);
+            }
+            x += CELL_WIDTH * scale;
+        }
+        return x;
+    }
+
+    // Đồ thị cột frame time HISTORY frame gần nhất; vạch ngang tại targetMs (ví dụ 16.7 ms = 60 FPS)
+    void frameGraph(float x, float y, float w, float h, float maxMs, float targetMs) {
+        rect(x, y, w, h, 0x00000080);
+        float barWidth = w / HISTORY;
+        for (int i = 0; i < historyCount; ++i) {
+            // Frame cũ nhất bên trái
+            int index = (historyNext - historyCount + i + HISTORY) % HISTORY;
+            float ms = history[index];
+            float barHeight = min(ms / maxMs, 1.0f) * h;
+            uint32_t color = ms <= targetMs ? 0x40E040FF : ms <= 2.0f * targetMs ? 0xE0E040FF : 0xE04040FF;
+            rect(x + (HISTORY - historyCount + i) * barWidth, y, max(barWidth - 1.0f, 1.0f), barHeight, color);
+        }
+        rect(x, y + min(targetMs / maxMs, 1.0f) * h, w, 1.0f, 0xFFFFFF80);
+    }
+
+    // Chép toàn bộ quad của frame vào stream rồi vẽ một lần; trả về số draw call (0 nếu stream hết chỗ)
+    // Gọi khi blend đã bật; shader là biến thể UI_HUD của ui.vert/ui.frag
+    int draw(GLStateCache& state, StreamingAllocator& stream, Shader& shader, const Mat4& projection) {
+        if (vertices.empty()) return 0;
+        StreamingAllocator::Allocation block = stream.allocate(vertices.size() * sizeof(Vertex), sizeof(Vertex));
+        if (!block.data) return 0;
+        memcpy(block.data, &vertices[0], vertices.size() * sizeof(Vertex));
+        stream.commit(state);
+        state.useProgram(shader.ID);
+        shader.setMat4("projection", projection);
+        state.activeTexture(GL_TEXTURE1);
+        state.bindTexture(GL_TEXTURE_2D, atlasTexture);
+        state.bindVertexArray(vao);
+        glDrawArrays(GL_TRIANGLES, (GLint)(block.offset / sizeof(Vertex)), (GLsizei)vertices.size());
+        return 1;
+    }
+
+    size_t vertexCount() const { return vertices.size(); }
+
+    // Đọc /proc mỗi frame tốn hơn cả phần dựng HUD -> chỉ lấy mẫu lại sau MEMORY_SAMPLE_FRAMES lần gọi
+    size_t sampledResidentMemory() {
+        if (memorySampleAge-- <= 0) {
+            residentBytes = residentMemoryBytes();
+            memorySampleAge = MEMORY_SAMPLE_FRAMES;
+        }
+        return residentBytes;
+    }
+
+    // Bộ nhớ thường trú của tiến trình (byte), 0 nếu không đọc được trên nền tảng này
+    static size_t residentMemoryBytes() {
+#if defined(__linux__)
+        FILE* statm = fopen("/proc/self/statm", "r");
+        if (!statm) return 0;
+        long totalPages = 0, residentPages = 0;
+        int read = fscanf(statm, "%ld %ld", &totalPages, &residentPages);
+        fclose(statm);
+        return read == 2 ? (size_t)residentPages * (size_t)sysconf(_SC_PAGESIZE) : 0;
+#else
+        return 0;
+#endif
+    }
+
+private:
+    unsigned int vao = 0;
+    vector<Vertex> vertices;
+    float history[HISTORY] = {};
+    int historyNext = 0, historyCount = 0;
+    size_t residentBytes = 0;
+    int memorySampleAge = 0;
+
+    // Tâm ô khối đặc trong atlas
+    static float solidU() {
+        int glyph = HudFont::SOLID - HudFont::FIRST;
+        return ((glyph % ATLAS_COLUMNS) * CELL_WIDTH + HudFont::GLYPH_WIDTH * 0.5f) / ATLAS_WIDTH;
+    }
+    static float solidV() {
+        int glyph = HudFont::SOLID - HudFont::FIRST;
+        return ((glyph / ATLAS_COLUMNS) * CELL_HEIGHT + HudFont::GLYPH_HEIGHT * 0.5f) / ATLAS_HEIGHT;
+    }
+
+    void quad(float x0, float y0, float x1, float y1, float u0, float v0, float u1, float v1, uint32_t rgba) {
+        uint8_t r = rgba >> 24, g = (rgba >> 16) & 0xFF, b = (rgba >> 8) & 0xFF, a = rgba & 0xFF;
+        Vertex bl = { x0, y0, u0, v0, r, g, b, a };
+        Vertex br = { x1, y0, u1, v0, r, g, b, a };
+        Vertex tr = { x1, y1, u1, v1, r, g, b, a };
+        Vertex tl = { x0, y1, u0, v1, r, g, b, a };
+        vertices.push_back(bl);
+        vertices.push_back(br);
+        vertices.push_back(tr);
+        vertices.push_back(tr);
+        vertices.push_back(tl);
+        vertices.push_back(bl);
+    }
+};
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef INPUT_RECORDING_H
+#define INPUT_RECORDING_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "Logger.h"
+
+// Các phím processInput dùng, mỗi phím một bit trong InputFrame::keys (giữ nguyên thứ tự để file cũ còn đọc được)
+enum InputKey {
+    INPUT_KEY_ESCAPE, INPUT_KEY_W, INPUT_KEY_S, INPUT_KEY_A, INPUT_KEY_D,
+    INPUT_KEY_I, INPUT_KEY_K, INPUT_KEY_J, INPUT_KEY_L, INPUT_KEY_U, INPUT_KEY_O,
+    INPUT_KEY_P, INPUT_KEY_F, INPUT_KEY_H, INPUT_KEY_G,
+    INPUT_KEY_COUNT
+};
+
+// Toàn bộ input của một frame: đủ để processInput cho ra đúng cùng trạng thái camera/đèn/chế độ
+struct InputFrame {
+    float deltaTime = 0.0f;          // Giây
+    float mouseX = 0.0f, mouseY = 0.0f; // Tổng offset chuột trong frame (y đã đảo, giống mouse_callback)
+    uint32_t keys = 0;
+
+    bool pressed(InputKey key) const { return (keys >> key) & 1u; }
+    void press(InputKey key) { keys |= 1u << key; }
+};
+static_assert(sizeof(InputFrame) == 16, "InputFrame is written to disk as-is");
+
+// Ghi input từng frame ra file nhị phân: header cố định, sau đó là các InputFrame 16 byte liên tiếp
+// (~1 KB mỗi giây ở 60 FPS). Số frame suy ra từ kích thước file nên dừng giữa chừng vẫn đọc lại được
+class InputRecorder {
+public:
+    bool open(const string& path) {
+        file.open(path, ios::binary | ios::trunc);
+        if (!file.is_open()) {
+            LOG_ERROR("ERROR::INPUT_RECORDER::CANNOT_WRITE: " << path);
+            return false;
+        }
+        Header header = { MAGIC, VERSION, (uint32_t)sizeof(InputFrame), INPUT_KEY_COUNT };
+        file.write((const char*)&header, sizeof(header));
+        frames = 0;
+        return true;
+    }
+
+    bool isOpen() const { return file.is_open(); }
+
+    // ofstream tự gom vào buffer - không flush mỗi frame
+    void write(const InputFrame& frame) {
+        file.write((const char*)&frame, sizeof(frame));
+        ++frames;
+    }
+
+    size_t close() {
+        if (file.is_open()) file.close();
+        return frames;
+    }
+
+private:
+    friend class InputReplay;
+
+    static const uint32_t MAGIC = 0x4E495254; // "TRIN"
+    static const uint32_t VERSION = 1;
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t frameBytes;
+        uint32_t keyCount;
+    };
+
+    ofstream file;
+    size_t frames = 0;
+};
+
+// Đọc cả file vào bộ nhớ lúc mở, khi phát lại không còn I/O trên luồng render
+class InputReplay {
+public:
+    bool open(const string& path) {
+        ifstream file(path, ios::binary | ios::ate);
+        if (!file.is_open()) {
+            LOG_ERROR("ERROR::INPUT_REPLAY::CANNOT_READ: " << path);
+            return false;
+        }
+        size_t bytes = (size_t)file.tellg();
+        file.seekg(0);
+
+        InputRecorder::Header header;
+        if (bytes < sizeof(header) || !file.read((char*)&header, sizeof(header)) ||
+            header.magic != InputRecorder::MAGIC || header.version != InputRecorder::VERSION ||
+            header.frameBytes != sizeof(InputFrame) || header.keyCount != INPUT_KEY_COUNT) {
+            LOG_ERROR("ERROR::INPUT_REPLAY::INVALID_FILE: " << path);
+            return false;
+        }
+        size_t count = (bytes - sizeof(header)) / sizeof(InputFrame);
+        if ((bytes - sizeof(header)) % sizeof(InputFrame) != 0)
+            LOG_WARN("Input recording is truncated, replaying " << count << " complete frames: " << path);
+
+        frames.resize(count);
+        if (count > 0 && !file.read((char*)frames.data(), count * sizeof(InputFrame))) {
+            LOG_ERROR("ERROR::INPUT_REPLAY::CANNOT_READ: " << path);
+            frames.clear();
+            return false;
+        }
+        cursor = 0;
+        return true;
+    }
+
+    // false khi đã phát hết
+    bool next(InputFrame& frame) {
+        if (cursor >= frames.size()) return false;
+        frame = frames[cursor++];
+        return true;
+    }
+
+    size_t frameCount() const { return frames.size(); }
+
+private:
+    vector<InputFrame> frames;
+    size_t cursor = 0;
+};
+
+#endif
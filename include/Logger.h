@@ -0,0 +1,208 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+using namespace std;
+
+enum LogLevel { LOG_LEVEL_DEBUG, LOG_LEVEL_INFO, LOG_LEVEL_WARN, LOG_LEVEL_ERROR };
+
+// Log bất đồng bộ: luồng gọi chỉ định dạng chuỗi và đẩy vào hàng đợi vòng không khoá (nhiều producer, một consumer);
+// luồng writer nền ghi ra FILE* và flush theo lô. Hàng đợi đầy: INFO/DEBUG bị bỏ (đếm lại), WARN/ERROR (lỗi compile
+// shader, cache hỏng...) không bao giờ mất mà được ghi đồng bộ ngay từ luồng gọi - có thể ra trước các dòng còn trong hàng đợi
+//  - Chưa start() hoặc đã stop(): ghi đồng bộ ngay (lúc khởi động / thoát)
+//  - LOG_DEBUG bị xoá khỏi binary trừ khi build với TERRAIN_LOG_DEBUG (CMake -DDEBUG_LOG=ON)
+class Logger {
+public:
+    static const uint32_t QUEUE_CAPACITY = 1024; // Luỹ thừa của 2
+
+    // Giữ writer chạy trong một scope (thường là cả main)
+    class Scope {
+    public:
+        explicit Scope(FILE* out) { Logger::start(out); }
+        ~Scope() { Logger::stop(); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    static void setLevel(LogLevel level) { minLevel.store(level, memory_order_relaxed); }
+    static bool isEnabled(LogLevel level) { return level >= minLevel.load(memory_order_relaxed); }
+
+    static void start(FILE* out) {
+        lock_guard<mutex> lock(control);
+        output = out;
+        if (running.load()) return;
+        quit.store(false);
+        running.store(true);
+        writer = thread(writerLoop);
+    }
+
+    // Ghi nốt mọi dòng còn trong hàng đợi rồi dừng writer
+    static void stop() {
+        lock_guard<mutex> lock(control);
+        if (!running.load()) return;
+        // Từ đây write() mới đi đường đồng bộ (chờ control); producer đã vào đường async thì phải công bố xong
+        // ô của mình trước khi writer dừng - không dòng nào bị kẹt lại trong hàng đợi
+        running.store(false);
+        while (activeProducers.load() > 0) this_thread::yield();
+        quit.store(true);
+        wake.notify_one();
+        writer.join();
+        drain();
+        if (dropped.load() > 0) fprintf(output, "WARNING::LOGGER::DROPPED_LINES: %llu\n", (unsigned long long)dropped.load());
+        fflush(output);
+    }
+
+    // Chờ writer ghi hết các dòng đã gửi (trước khi ghi trực tiếp ra cùng FILE*, ví dụ bảng timeline)
+    static void flush() {
+        if (!running.load()) return;
+        uint64_t target = enqueuePos.load(memory_order_acquire);
+        wake.notify_one();
+        unique_lock<mutex> lock(flushGuard);
+        // Writer báo sau mỗi lô; timeout chỉ để không treo nếu writer đã bị stop() giữa chừng
+        while (consumed.load(memory_order_acquire) < target && running.load())
+            drained.wait_for(lock, chrono::milliseconds(5));
+        fflush(output);
+    }
+
+    static void write(LogLevel level, string text) {
+        // Đăng ký là producer trước khi đọc running (seq_cst cả hai phía): hoặc thấy stop() đã tắt running,
+        // hoặc stop() thấy activeProducers > 0 và chờ ô này được công bố
+        activeProducers.fetch_add(1);
+        if (!running.load()) {
+            activeProducers.fetch_sub(1);
+            lock_guard<mutex> lock(control);
+            writeLine(level, text);
+            fflush(output);
+            return;
+        }
+        // Vyukov bounded queue: giành một ô bằng CAS trên enqueuePos, công bố bằng sequence của ô
+        uint64_t pos = enqueuePos.load(memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &slots[pos & (QUEUE_CAPACITY - 1)];
+            uint64_t sequence = slot->sequence.load(memory_order_acquire);
+            int64_t diff = (int64_t)sequence - (int64_t)pos;
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                // Đầy
+                activeProducers.fetch_sub(1);
+                if (level < LOG_LEVEL_WARN) {
+                    dropped.fetch_add(1, memory_order_relaxed);
+                    return;
+                }
+                writeLine(level, text);
+                fflush(output);
+                return;
+            } else {
+                pos = enqueuePos.load(memory_order_relaxed);
+            }
+        }
+        slot->level = level;
+        slot->text = move(text);
+        slot->sequence.store(pos + 1, memory_order_release);
+        activeProducers.fetch_sub(1);
+        if (writerIdle.load(memory_order_relaxed)) wake.notify_one(); // Writer đang thức thì khỏi syscall
+    }
+
+    static uint64_t droppedCount() { return dropped.load(memory_order_relaxed); }
+
+private:
+    struct Slot {
+        atomic<uint64_t> sequence;
+        LogLevel level;
+        string text;
+    };
+
+    static Slot* makeSlots() {
+        Slot* s = new Slot[QUEUE_CAPACITY];
+        for (uint32_t i = 0; i < QUEUE_CAPACITY; ++i) s[i].sequence.store(i, memory_order_relaxed);
+        return s;
+    }
+
+    static inline Slot* slots = makeSlots();
+    static inline atomic<uint64_t> enqueuePos{ 0 };
+    static inline uint64_t dequeuePos = 0; // Chỉ writer (hoặc stop() sau khi writer đã dừng) đụng tới
+    static inline atomic<uint64_t> consumed{ 0 };
+    static inline atomic<uint64_t> dropped{ 0 };
+    static inline atomic<int> minLevel{ LOG_LEVEL_DEBUG };
+    static inline atomic<bool> running{ false };
+    static inline atomic<int> activeProducers{ 0 }; // write() đang ở đường async (đã giành hoặc sắp giành ô)
+    static inline atomic<bool> quit{ false };
+    static inline atomic<bool> writerIdle{ false };
+    static inline FILE* output = stdout;
+    static inline thread writer;
+    static inline mutex control;     // start/stop và ghi đồng bộ - không dùng trên đường async
+    static inline mutex wakeGuard;   // Chỉ writer khoá (để chờ condition variable)
+    static inline condition_variable wake;
+    static inline mutex flushGuard;  // Chỉ flush() chờ trên đây
+    static inline condition_variable drained;
+
+    // Một lệnh fwrite cho cả dòng: stdio khoá theo từng lệnh, dòng ghi đồng bộ lúc hàng đợi đầy không chen vào giữa
+    // dòng của writer. Thêm '\n' vào chính text (bản sao của người gọi hoặc ô sắp được xoá)
+    static void writeLine(LogLevel level, string& text) {
+        (void)level; // Giữ nguyên định dạng cũ: lỗi đã tự mang tiền tố "ERROR::"
+        text += '\n';
+        fwrite(text.data(), 1, text.size(), output);
+    }
+
+    // Ghi mọi dòng đã công bố; trả về số dòng
+    static int drain() {
+        int count = 0;
+        for (;;) {
+            Slot& slot = slots[dequeuePos & (QUEUE_CAPACITY - 1)];
+            if (slot.sequence.load(memory_order_acquire) != dequeuePos + 1) break;
+            writeLine(slot.level, slot.text);
+            slot.text.clear();
+            slot.sequence.store(dequeuePos + QUEUE_CAPACITY, memory_order_release);
+            ++dequeuePos;
+            consumed.store(dequeuePos, memory_order_release);
+            ++count;
+        }
+        return count;
+    }
+
+    static void writerLoop() {
+        while (!quit.load()) {
+            if (drain() > 0) {
+                fflush(output); // Một lần flush cho cả lô
+                drained.notify_all();
+                continue;
+            }
+            // notify_one của producer có thể đến trước khi writer kịp chờ -> timeout ngắn thay vì khoá trên producer
+            unique_lock<mutex> lock(wakeGuard);
+            writerIdle.store(true);
+            wake.wait_for(lock, chrono::milliseconds(5));
+            writerIdle.store(false);
+        }
+    }
+};
+
+// Dùng như stream: LOG_INFO("Display Mode: " << name)
+#define LOG_AT(level, expr)                                  \
+    do {                                                     \
+        if (Logger::isEnabled(level)) {                      \
+            ostringstream logStream;                         \
+            logStream << expr;                               \
+            Logger::write(level, logStream.str());           \
+        }                                                    \
+    } while (0)
+
+#if defined(TERRAIN_LOG_DEBUG)
+#define LOG_DEBUG(expr) LOG_AT(LOG_LEVEL_DEBUG, expr)
+#else
+#define LOG_DEBUG(expr) do {} while (0)
+#endif
+#define LOG_INFO(expr) LOG_AT(LOG_LEVEL_INFO, expr)
+#define LOG_WARN(expr) LOG_AT(LOG_LEVEL_WARN, expr)
+#define LOG_ERROR(expr) LOG_AT(LOG_LEVEL_ERROR, expr)
+
+#endif
@@ -3,48 +3,196 @@
 
 #include <cmath>
 #include <iostream>
+#include <type_traits>
 
-const float PI = 3.14159265359f;
+#include "Simd.h"
+
+constexpr float PI = 3.14159265359f;
+
+// Phát hiện đang được tính lúc biên dịch (constant evaluation) để chọn đường constexpr
+#if defined(__cpp_lib_is_constant_evaluated)
+#define MATH3D_IS_CONSTANT_EVALUATED() std::is_constant_evaluated()
+#else
+#define MATH3D_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#endif
+
+// Hàm toán học dùng được trong constexpr: lúc biên dịch dùng chuỗi Taylor/Newton (double),
+// lúc chạy gọi thẳng hàm của <cmath>
+namespace math3d {
+    // Đưa góc về [-PI, PI]
+    constexpr double wrapAngle(double x) {
+        const double TWO_PI = 6.283185307179586;
+        double k = x / TWO_PI;
+        long long n = (long long)(k < 0 ? k - 0.5 : k + 0.5);
+        return x - n * TWO_PI;
+    }
+
+    constexpr double sinSeries(double x) {
+        x = wrapAngle(x);
+        double term = x, sum = x;
+        for (int i = 1; i < 16; i++) {
+            term *= -x * x / ((2 * i) * (2 * i + 1));
+            sum += term;
+        }
+        return sum;
+    }
+
+    constexpr double sqrtNewton(double x) {
+        if (!(x > 0)) return 0;
+        double r = x > 1 ? x : 1;
+        for (int i = 0; i < 64; i++) {
+            double next = 0.5 * (r + x / r);
+            if (next == r) break;
+            r = next;
+        }
+        return r;
+    }
+
+    constexpr float sqrt(float x) {
+        if (MATH3D_IS_CONSTANT_EVALUATED()) return (float)sqrtNewton(x);
+        return std::sqrt(x);
+    }
+    constexpr float sin(float x) {
+        if (MATH3D_IS_CONSTANT_EVALUATED()) return (float)sinSeries(x);
+        return std::sin(x);
+    }
+    constexpr float cos(float x) {
+        if (MATH3D_IS_CONSTANT_EVALUATED()) return (float)sinSeries(x + 1.5707963267948966);
+        return std::cos(x);
+    }
+    constexpr float tan(float x) {
+        if (MATH3D_IS_CONSTANT_EVALUATED()) return (float)(sinSeries(x) / sinSeries(x + 1.5707963267948966));
+        return std::tan(x);
+    }
+}
 
 //  Vector cơ bản
 struct Vec3 {
     float x, y, z;
-    Vec3() : x(0), y(0), z(0) {}
-    Vec3(float _x, float _y, float _z) : x(_x), y(_y), z(_z) {}
+    constexpr Vec3() : x(0), y(0), z(0) {}
+    constexpr Vec3(float _x, float _y, float _z) : x(_x), y(_y), z(_z) {}
 
-    Vec3 operator+(const Vec3& v) const { return Vec3(x + v.x, y + v.y, z + v.z); }
-    Vec3 operator-(const Vec3& v) const { return Vec3(x - v.x, y - v.y, z - v.z); }
-    Vec3 operator*(float s) const { return Vec3(x * s, y * s, z * s); }
+    constexpr Vec3 operator+(const Vec3& v) const { return Vec3(x + v.x, y + v.y, z + v.z); }
+    constexpr Vec3 operator-(const Vec3& v) const { return Vec3(x - v.x, y - v.y, z - v.z); }
+    constexpr Vec3 operator*(float s) const { return Vec3(x * s, y * s, z * s); }
     
     // Tích vô hướng (Dot product) -  dùng cho chiếu sáng
-    float dot(const Vec3& v) const { return x * v.x + y * v.y + z * v.z; }
+    constexpr float dot(const Vec3& v) const { return x * v.x + y * v.y + z * v.z; }
 
     // Tích có hướng (Cross product) - dùng tính pháp tuyến
-    Vec3 cross(const Vec3& v) const {
+    constexpr Vec3 cross(const Vec3& v) const {
         return Vec3(y * v.z - z * v.y, z * v.x - x * v.z, x * v.y - y * v.x);
     }
 
     // Chuẩn hóa vector
-    Vec3 normalize() {
-        float len = sqrt(x * x + y * y + z * z);
+    constexpr Vec3 normalize() const {
+        float len = math3d::sqrt(x * x + y * y + z * z);
         if (len > 0) return Vec3(x / len, y / len, z / len);
         return *this;
     }
 };
 
+// Gói N vector dạng Structure-of-Arrays: mỗi thành phần là một thanh ghi SIMD
+// Dùng cho các vòng lặp khối (pháp tuyến, biến đổi, culling) - mỗi phép tính xử lý N vector
+template <typename F>
+struct Vec3xN {
+    static const int LANES = F::LANES;
+    F x, y, z;
+
+    Vec3xN() {}
+    Vec3xN(F _x, F _y, F _z) : x(_x), y(_y), z(_z) {}
+    explicit Vec3xN(const Vec3& v) : x(v.x), y(v.y), z(v.z) {} // Nhân bản ra mọi làn
+
+    Vec3xN operator+(const Vec3xN& v) const { return Vec3xN(x + v.x, y + v.y, z + v.z); }
+    Vec3xN operator-(const Vec3xN& v) const { return Vec3xN(x - v.x, y - v.y, z - v.z); }
+    Vec3xN operator*(F s) const { return Vec3xN(x * s, y * s, z * s); }
+
+    F dot(const Vec3xN& v) const { return x * v.x + y * v.y + z * v.z; }
+
+    Vec3xN cross(const Vec3xN& v) const {
+        return Vec3xN(y * v.z - z * v.y, z * v.x - x * v.z, x * v.y - y * v.x);
+    }
+
+    // Chuẩn hoá nhanh bằng rsqrt xấp xỉ; vector 0 vẫn giữ là 0 như Vec3::normalize
+    Vec3xN normalize() const {
+        F lenSq = max(dot(*this), F(1.0e-30f));
+        return *this * rsqrt(lenSq);
+    }
+
+    // Đọc N vector từ mảng xen kẽ: làn i lấy base[i*stride .. i*stride+2]
+    // Mặc định stride 6 = layout đỉnh (x, y, z, nx, ny, nz); truyền base + 3 để đọc pháp tuyến
+    static Vec3xN loadInterleaved(const float* base, int stride = 6) {
+        alignas(32) float tx[LANES], ty[LANES], tz[LANES];
+        for (int i = 0; i < LANES; i++) {
+            tx[i] = base[i * stride];
+            ty[i] = base[i * stride + 1];
+            tz[i] = base[i * stride + 2];
+        }
+        return Vec3xN(F::load(tx), F::load(ty), F::load(tz));
+    }
+
+    // Ghi ngược N vector vào mảng xen kẽ, không đụng các float khác trong mỗi đỉnh
+    void storeInterleaved(float* base, int stride = 6) const {
+        alignas(32) float tx[LANES], ty[LANES], tz[LANES];
+        x.store(tx); y.store(ty); z.store(tz);
+        for (int i = 0; i < LANES; i++) {
+            base[i * stride] = tx[i];
+            base[i * stride + 1] = ty[i];
+            base[i * stride + 2] = tz[i];
+        }
+    }
+
+    // Đọc/ghi N vector liên tiếp từ ba mảng SoA (không cần căn lề)
+    static Vec3xN loadu(const float* px, const float* py, const float* pz) {
+        return Vec3xN(F::loadu(px), F::loadu(py), F::loadu(pz));
+    }
+
+    void storeu(float* px, float* py, float* pz) const { x.storeu(px); y.storeu(py); z.storeu(pz); }
+
+    Vec3 lane(int i) const {
+        alignas(32) float tx[LANES], ty[LANES], tz[LANES];
+        x.store(tx); y.store(ty); z.store(tz);
+        return Vec3(tx[i], ty[i], tz[i]);
+    }
+};
+
+typedef Vec3xN<f32x4> Vec3x4;
+typedef Vec3xN<f32x8> Vec3x8;
+
 struct Vec4 { float x, y, z, w; };
 
+//  Ma trận 3x3 (lưu theo cột như Mat4) - dùng làm normal matrix gửi xuống shader
+struct Mat3 {
+    float m[3][3];
+
+    constexpr Mat3() : m{ {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f} } {}
+    // Dựng từ 3 cột
+    constexpr Mat3(const Vec3& c0, const Vec3& c1, const Vec3& c2)
+        : m{ {c0.x, c0.y, c0.z}, {c1.x, c1.y, c1.z}, {c2.x, c2.y, c2.z} } {}
+
+    constexpr Vec3 column(int i) const { return Vec3(m[i][0], m[i][1], m[i][2]); }
+
+    constexpr const float* value_ptr() const { return &m[0][0]; }
+};
+
 //  Ma trận 4x4 cho biến đổi Affine
-struct Mat4 {
+// Căn 16 byte để mỗi hàng m[i] nạp thẳng vào một thanh ghi SIMD.
+// Các hàm đều constexpr: lúc biên dịch dùng vòng lặp vô hướng, lúc chạy dùng SIMD
+struct alignas(16) Mat4 {
     float m[4][4];
 
-    Mat4() {
-        for (int i = 0; i < 4; i++)
-            for (int j = 0; j < 4; j++) m[i][j] = (i == j) ? 1.0f : 0.0f;
-    }
+    // Tag cho constructor không khởi tạo - dùng ở hot path khi giá trị bị ghi đè ngay
+    struct NoInit {};
+
+    constexpr Mat4() : m{ {1.0f, 0.0f, 0.0f, 0.0f},
+                          {0.0f, 1.0f, 0.0f, 0.0f},
+                          {0.0f, 0.0f, 1.0f, 0.0f},
+                          {0.0f, 0.0f, 0.0f, 1.0f} } {}
+    explicit Mat4(NoInit) {}
 
-    // Phép nhân ma trận 
-    Mat4 operator*(const Mat4& other) const {
+    // Phép nhân ma trận: hàng i của kết quả = tổ hợp tuyến tính các hàng của other
+    constexpr Mat4 operator*(const Mat4& other) const {
+        if (!MATH3D_IS_CONSTANT_EVALUATED()) return multiplySimd(*this, other);
         Mat4 res;
         for (int i = 0; i < 4; i++) {
             for (int j = 0; j < 4; j++) {
@@ -56,34 +204,51 @@ struct Mat4 {
         return res;
     }
 
+    // Ma trận chuyển vị
+    constexpr Mat4 transpose() const {
+        if (!MATH3D_IS_CONSTANT_EVALUATED()) return transposeSimd(*this);
+        Mat4 res;
+        for (int i = 0; i < 4; i++)
+            for (int j = 0; j < 4; j++) res.m[i][j] = m[j][i];
+        return res;
+    }
+
+    // Biến đổi điểm (w = 1), cùng quy ước với shader: model * vec4(p, 1.0)
+    constexpr Vec3 transformPoint(const Vec3& p) const {
+        if (!MATH3D_IS_CONSTANT_EVALUATED()) return transformPointSimd(*this, p);
+        return Vec3(p.x * m[0][0] + p.y * m[1][0] + p.z * m[2][0] + m[3][0],
+                    p.x * m[0][1] + p.y * m[1][1] + p.z * m[2][1] + m[3][1],
+                    p.x * m[0][2] + p.y * m[1][2] + p.z * m[2][2] + m[3][2]);
+    }
+
     //Ma trận Tịnh tiến
-    static Mat4 translate(const Vec3& v) {
+    static constexpr Mat4 translate(const Vec3& v) {
         Mat4 res;
         res.m[3][0] = v.x; res.m[3][1] = v.y; res.m[3][2] = v.z;
         return res;
     }
 
     //  Ma trận Tỉ lệ
-    static Mat4 scale(const Vec3& v) {
+    static constexpr Mat4 scale(const Vec3& v) {
         Mat4 res;
         res.m[0][0] = v.x; res.m[1][1] = v.y; res.m[2][2] = v.z;
         return res;
     }
 
     //  Ma trận Quay quanh trục Y
-    static Mat4 rotateY(float angle) {
+    static constexpr Mat4 rotateY(float angle) {
         Mat4 res;
-        float c = cos(angle);
-        float s = sin(angle);
+        float c = math3d::cos(angle);
+        float s = math3d::sin(angle);
         res.m[0][0] = c;  res.m[0][2] = -s;
         res.m[2][0] = s;  res.m[2][2] = c;
         return res;
     }
 
     //  Phép chiếu phối cảnh (Perspective Projection)
-    static Mat4 perspective(float fov, float aspect, float near, float far) {
+    static constexpr Mat4 perspective(float fov, float aspect, float near, float far) {
         Mat4 res;
-        float tanHalfFov = tan(fov / 2.0f);
+        float tanHalfFov = math3d::tan(fov / 2.0f);
         res.m[0][0] = 0; res.m[1][1] = 0; res.m[2][2] = 0; res.m[3][3] = 0; // Reset identity
         
         res.m[0][0] = 1.0f / (aspect * tanHalfFov);
@@ -95,7 +260,7 @@ struct Mat4 {
     }
 
     //  Phép chiếu trực giao (Orthographic) cho Minimap
-    static Mat4 ortho(float left, float right, float bottom, float top, float near, float far) {
+    static constexpr Mat4 ortho(float left, float right, float bottom, float top, float near, float far) {
         Mat4 res;
         res.m[0][0] = 2.0f / (right - left);
         res.m[1][1] = 2.0f / (top - bottom);
@@ -107,7 +272,7 @@ struct Mat4 {
     }
 
     //  Quan sát đối tượng 3D (LookAt)
-    static Mat4 lookAt(Vec3 eye, Vec3 center, Vec3 up) {
+    static constexpr Mat4 lookAt(Vec3 eye, Vec3 center, Vec3 up) {
         Vec3 f = (center - eye).normalize(); // Forward
         Vec3 u = up.normalize();
         Vec3 s = f.cross(u).normalize();     // Side
@@ -123,8 +288,221 @@ struct Mat4 {
         return res;
     }
     
+    // Cột thứ i (3 thành phần đầu) theo quy ước của shader
+    constexpr Vec3 column(int i) const { return Vec3(m[i][0], m[i][1], m[i][2]); }
+
+    //  Ma trận nghịch đảo tổng quát (khử theo các định thức con 2x2)
+    // Ma trận suy biến (det = 0) trả về ma trận đơn vị
+    constexpr Mat4 inverse() const {
+        if (!MATH3D_IS_CONSTANT_EVALUATED()) return inverseSimd(*this);
+        return inverseScalar(*this);
+    }
+
+    //  Nghịch đảo nhanh cho ma trận Affine (hàng cuối = 0 0 0 1): [A t]^-1 = [A^-1  -A^-1 t]
+    // A^-1 tính bằng tích có hướng các cột của A
+    constexpr Mat4 inverseAffine() const {
+        Vec3 c0 = column(0), c1 = column(1), c2 = column(2);
+        Vec3 r0 = c1.cross(c2), r1 = c2.cross(c0), r2 = c0.cross(c1); // Các hàng của adj(A)
+        float det = c0.dot(r0);
+        if (det == 0.0f) return Mat4();
+        float invDet = 1.0f / det;
+        r0 = r0 * invDet; r1 = r1 * invDet; r2 = r2 * invDet;
+
+        Vec3 t = column(3);
+        Mat4 res;
+        res.m[0][0] = r0.x; res.m[1][0] = r0.y; res.m[2][0] = r0.z; res.m[3][0] = -r0.dot(t);
+        res.m[0][1] = r1.x; res.m[1][1] = r1.y; res.m[2][1] = r1.z; res.m[3][1] = -r1.dot(t);
+        res.m[0][2] = r2.x; res.m[1][2] = r2.y; res.m[2][2] = r2.z; res.m[3][2] = -r2.dot(t);
+        return res;
+    }
+
+    //  Nghịch đảo cho phép biến đổi cứng (chỉ quay + tịnh tiến): A^-1 = A^T
+    // Dùng cho view matrix từ lookAt
+    constexpr Mat4 inverseRigid() const {
+        Vec3 c0 = column(0), c1 = column(1), c2 = column(2);
+        Vec3 t = column(3);
+        Mat4 res;
+        res.m[0][0] = c0.x; res.m[1][0] = c0.y; res.m[2][0] = c0.z; res.m[3][0] = -c0.dot(t);
+        res.m[0][1] = c1.x; res.m[1][1] = c1.y; res.m[2][1] = c1.z; res.m[3][1] = -c1.dot(t);
+        res.m[0][2] = c2.x; res.m[1][2] = c2.y; res.m[2][2] = c2.z; res.m[3][2] = -c2.dot(t);
+        return res;
+    }
+
+    //  Normal matrix = (A^-1)^T của phần 3x3, biến đổi pháp tuyến đúng cả khi scale không đều
+    // Cột i của (A^-1)^T chính là hàng i của A^-1
+    constexpr Mat3 normalMatrix() const {
+        Vec3 c0 = column(0), c1 = column(1), c2 = column(2);
+        Vec3 r0 = c1.cross(c2), r1 = c2.cross(c0), r2 = c0.cross(c1);
+        float det = c0.dot(r0);
+        if (det == 0.0f) return Mat3();
+        float invDet = 1.0f / det;
+        return Mat3(r0 * invDet, r1 * invDet, r2 * invDet);
+    }
+
     // Chuyển đổi sang mảng float để gửi xuống Shader
-    const float* value_ptr() const { return &m[0][0]; }
+    constexpr const float* value_ptr() const { return &m[0][0]; }
+
+private:
+    // aij = m[i][j]; nghịch đảo không phụ thuộc quy ước hàng/cột vì (M^T)^-1 = (M^-1)^T
+    static constexpr Mat4 inverseScalar(const Mat4& a) {
+        float a00 = a.m[0][0], a01 = a.m[0][1], a02 = a.m[0][2], a03 = a.m[0][3];
+        float a10 = a.m[1][0], a11 = a.m[1][1], a12 = a.m[1][2], a13 = a.m[1][3];
+        float a20 = a.m[2][0], a21 = a.m[2][1], a22 = a.m[2][2], a23 = a.m[2][3];
+        float a30 = a.m[3][0], a31 = a.m[3][1], a32 = a.m[3][2], a33 = a.m[3][3];
+
+        float s0 = a00 * a11 - a10 * a01, s1 = a00 * a12 - a10 * a02, s2 = a00 * a13 - a10 * a03;
+        float s3 = a01 * a12 - a11 * a02, s4 = a01 * a13 - a11 * a03, s5 = a02 * a13 - a12 * a03;
+        float c5 = a22 * a33 - a32 * a23, c4 = a21 * a33 - a31 * a23, c3 = a21 * a32 - a31 * a22;
+        float c2 = a20 * a33 - a30 * a23, c1 = a20 * a32 - a30 * a22, c0 = a20 * a31 - a30 * a21;
+
+        float det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+        if (det == 0.0f) return Mat4();
+        float inv = 1.0f / det;
+
+        Mat4 res;
+        res.m[0][0] = ( a11 * c5 - a12 * c4 + a13 * c3) * inv;
+        res.m[0][1] = (-a01 * c5 + a02 * c4 - a03 * c3) * inv;
+        res.m[0][2] = ( a31 * s5 - a32 * s4 + a33 * s3) * inv;
+        res.m[0][3] = (-a21 * s5 + a22 * s4 - a23 * s3) * inv;
+        res.m[1][0] = (-a10 * c5 + a12 * c2 - a13 * c1) * inv;
+        res.m[1][1] = ( a00 * c5 - a02 * c2 + a03 * c1) * inv;
+        res.m[1][2] = (-a30 * s5 + a32 * s2 - a33 * s1) * inv;
+        res.m[1][3] = ( a20 * s5 - a22 * s2 + a23 * s1) * inv;
+        res.m[2][0] = ( a10 * c4 - a11 * c2 + a13 * c0) * inv;
+        res.m[2][1] = (-a00 * c4 + a01 * c2 - a03 * c0) * inv;
+        res.m[2][2] = ( a30 * s4 - a31 * s2 + a33 * s0) * inv;
+        res.m[2][3] = (-a20 * s4 + a21 * s2 - a23 * s0) * inv;
+        res.m[3][0] = (-a10 * c3 + a11 * c1 - a12 * c0) * inv;
+        res.m[3][1] = ( a00 * c3 - a01 * c1 + a02 * c0) * inv;
+        res.m[3][2] = (-a30 * s3 + a31 * s1 - a32 * s0) * inv;
+        res.m[3][3] = ( a20 * s3 - a21 * s1 + a22 * s0) * inv;
+        return res;
+    }
+
+#if defined(MATH3D_SSE)
+    // Nghịch đảo theo khối 2x2: M = [A B; C D], mỗi khối 2x2 nằm gọn trong một __m128
+    // (thứ tự phần tử trong khối: a00 a01 a10 a11)
+    static __m128 mat2Mul(__m128 a, __m128 b) {        // A * B
+        return _mm_add_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 3, 0))),
+                          _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)),
+                                     _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+    }
+    static __m128 mat2AdjMul(__m128 a, __m128 b) {     // adj(A) * B
+        return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 3, 3)), b),
+                          _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 1, 1)),
+                                     _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2))));
+    }
+    static __m128 mat2MulAdj(__m128 a, __m128 b) {     // A * adj(B)
+        return _mm_sub_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 0, 3))),
+                          _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)),
+                                     _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+    }
+
+    static Mat4 inverseSimd(const Mat4& in) {
+        __m128 r0 = _mm_load_ps(in.m[0]), r1 = _mm_load_ps(in.m[1]);
+        __m128 r2 = _mm_load_ps(in.m[2]), r3 = _mm_load_ps(in.m[3]);
+
+        __m128 A = _mm_movelh_ps(r0, r1);
+        __m128 B = _mm_movehl_ps(r1, r0);
+        __m128 C = _mm_movelh_ps(r2, r3);
+        __m128 D = _mm_movehl_ps(r3, r2);
+
+        // Định thức 4 khối (|A| |B| |C| |D|)
+        __m128 detSub = _mm_sub_ps(
+            _mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(3, 1, 3, 1))),
+            _mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(2, 0, 2, 0))));
+        __m128 detA = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(0, 0, 0, 0));
+        __m128 detB = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(1, 1, 1, 1));
+        __m128 detC = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(2, 2, 2, 2));
+        __m128 detD = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(3, 3, 3, 3));
+
+        __m128 D_C = mat2AdjMul(D, C);
+        __m128 A_B = mat2AdjMul(A, B);
+        __m128 X_ = _mm_sub_ps(_mm_mul_ps(detD, A), mat2Mul(B, D_C));
+        __m128 W_ = _mm_sub_ps(_mm_mul_ps(detA, D), mat2Mul(C, A_B));
+        __m128 Y_ = _mm_sub_ps(_mm_mul_ps(detB, C), mat2MulAdj(D, A_B));
+        __m128 Z_ = _mm_sub_ps(_mm_mul_ps(detC, B), mat2MulAdj(A, D_C));
+
+        // |M| = |A||D| + |B||C| - tr(adj(A)B * adj(D)C)
+        __m128 tr = _mm_mul_ps(A_B, _mm_shuffle_ps(D_C, D_C, _MM_SHUFFLE(3, 1, 2, 0)));
+        tr = _mm_add_ps(tr, _mm_movehl_ps(tr, tr));
+        tr = _mm_add_ss(tr, _mm_shuffle_ps(tr, tr, _MM_SHUFFLE(1, 1, 1, 1)));
+        __m128 detM = _mm_sub_ss(_mm_add_ss(_mm_mul_ss(detA, detD), _mm_mul_ss(detB, detC)), tr);
+        if (_mm_cvtss_f32(detM) == 0.0f) return Mat4();
+        detM = _mm_shuffle_ps(detM, detM, _MM_SHUFFLE(0, 0, 0, 0));
+
+        __m128 rDetM = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), detM);
+        X_ = _mm_mul_ps(X_, rDetM);
+        Y_ = _mm_mul_ps(Y_, rDetM);
+        Z_ = _mm_mul_ps(Z_, rDetM);
+        W_ = _mm_mul_ps(W_, rDetM);
+
+        // Áp dụng phép adjugate và ghi ra theo hàng
+        Mat4 res{NoInit()};
+        _mm_store_ps(res.m[0], _mm_shuffle_ps(X_, Y_, _MM_SHUFFLE(1, 3, 1, 3)));
+        _mm_store_ps(res.m[1], _mm_shuffle_ps(X_, Y_, _MM_SHUFFLE(0, 2, 0, 2)));
+        _mm_store_ps(res.m[2], _mm_shuffle_ps(Z_, W_, _MM_SHUFFLE(1, 3, 1, 3)));
+        _mm_store_ps(res.m[3], _mm_shuffle_ps(Z_, W_, _MM_SHUFFLE(0, 2, 0, 2)));
+        return res;
+    }
+#else
+    static Mat4 inverseSimd(const Mat4& a) { return inverseScalar(a); }
+#endif
+
+    static Mat4 multiplySimd(const Mat4& a, const Mat4& b) {
+        f32x4 b0 = f32x4::load(b.m[0]);
+        f32x4 b1 = f32x4::load(b.m[1]);
+        f32x4 b2 = f32x4::load(b.m[2]);
+        f32x4 b3 = f32x4::load(b.m[3]);
+
+        // Tính đủ 4 hàng trước khi ghi để res không bị coi là trùng vùng nhớ với toán hạng.
+        // Nạp cả hàng a rồi nhân bản từng làn bằng shuffle (4 lần broadcast vô hướng từ bộ nhớ thì chậm hơn
+        // vòng lặp vô hướng đã được compiler tự vector hoá); cộng theo cặp để rút ngắn chuỗi phụ thuộc
+        f32x4 r[4];
+        for (int i = 0; i < 4; i++) {
+            f32x4 row = f32x4::load(a.m[i]);
+            r[i] = (row.broadcast<0>() * b0 + row.broadcast<1>() * b1)
+                 + (row.broadcast<2>() * b2 + row.broadcast<3>() * b3);
+        }
+
+        Mat4 res{NoInit()};
+        r[0].store(res.m[0]); r[1].store(res.m[1]); r[2].store(res.m[2]); r[3].store(res.m[3]);
+        return res;
+    }
+
+    static Mat4 transposeSimd(const Mat4& a) {
+        f32x4 r0 = f32x4::load(a.m[0]);
+        f32x4 r1 = f32x4::load(a.m[1]);
+        f32x4 r2 = f32x4::load(a.m[2]);
+        f32x4 r3 = f32x4::load(a.m[3]);
+        transpose4(r0, r1, r2, r3);
+
+        Mat4 res{NoInit()};
+        r0.store(res.m[0]); r1.store(res.m[1]); r2.store(res.m[2]); r3.store(res.m[3]);
+        return res;
+    }
+
+    static Vec3 transformPointSimd(const Mat4& a, const Vec3& p) {
+        f32x4 r = f32x4(p.x) * f32x4::load(a.m[0]) + f32x4(p.y) * f32x4::load(a.m[1])
+                + f32x4(p.z) * f32x4::load(a.m[2]) + f32x4::load(a.m[3]);
+        alignas(16) float out[4];
+        r.store(out);
+        return Vec3(out[0], out[1], out[2]);
+    }
 };
 
+// Kiểm tra lúc biên dịch: các hàm trên gấp hằng hoàn toàn khi đối số là hằng
+static_assert(math3d::sqrt(16.0f) == 4.0f, "constexpr sqrt");
+static_assert(math3d::sin(PI / 6.0f) > 0.499999f && math3d::sin(PI / 6.0f) < 0.500001f, "constexpr sin");
+static_assert(math3d::cos(PI) > -1.000001f && math3d::cos(PI) < -0.999999f, "constexpr cos");
+static_assert(Vec3(3.0f, 0.0f, 4.0f).normalize().z == 0.8f, "constexpr normalize");
+static_assert((Mat4::translate(Vec3(1.0f, 2.0f, 3.0f)) * Mat4::scale(Vec3(2.0f, 2.0f, 2.0f))).m[3][1] == 4.0f,
+              "constexpr Mat4 multiply");
+static_assert(Mat4::translate(Vec3(5.0f, 0.0f, 0.0f)).transpose().m[0][3] == 5.0f, "constexpr transpose");
+static_assert(Mat4::translate(Vec3(1.0f, 2.0f, 3.0f)).transformPoint(Vec3(1.0f, 1.0f, 1.0f)).z == 4.0f,
+              "constexpr transformPoint");
+static_assert(Mat4::translate(Vec3(1.0f, 2.0f, 3.0f)).inverseAffine().m[3][2] == -3.0f, "constexpr affine inverse");
+static_assert(Mat4::scale(Vec3(2.0f, 4.0f, 1.0f)).inverse().m[1][1] == 0.25f, "constexpr inverse");
+static_assert(Mat4::scale(Vec3(2.0f, 4.0f, 1.0f)).normalMatrix().m[0][0] == 0.5f, "constexpr normal matrix");
+
 #endif
\ No newline at end of file
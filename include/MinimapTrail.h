@@ -0,0 +1,120 @@
+#ifndef MINIMAP_TRAIL_H
+#define MINIMAP_TRAIL_H
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+using namespace std;
+
+#include "GLStateCache.h"
+#include "Hud.h"
+#include "Math3D.h"
+#include "Shader.h"
+
+// Đường đi trên minimap lưu dạng bitmap chiếm chỗ SIZE x SIZE (1 byte/pixel) thay vì danh sách điểm:
+// bộ nhớ cố định, đi qua một pixel nhiều lần không tốn thêm gì. Bản sao trên GPU là texture R8,
+// mỗi frame chỉ upload hình chữ nhật bao các pixel mới (glTexSubImage2D) và vẽ bằng một quad
+class MinimapTrail {
+public:
+    static const int SIZE = 200;
+    static const int DOT = 2; // Cạnh mỗi chấm (pixel), bằng glPointSize cũ của path trace
+
+    unsigned int texture = 0;
+
+    // Gọi sau khi có context; (x, y) là góc dưới bên trái minimap trên màn hình, rgba: 0xRRGGBBAA
+    void create(float x, float y, uint32_t rgba) {
+        bitmap.assign(SIZE * SIZE, 0);
+        clearDirty();
+
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, SIZE, SIZE, 0, GL_RED, GL_UNSIGNED_BYTE, &bitmap[0]);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        // Quad cố định phủ minimap, cùng layout đỉnh với HUD (vẽ bằng shader UI_HUD)
+        uint8_t r = rgba >> 24, g = (rgba >> 16) & 0xFF, b = (rgba >> 8) & 0xFF, a = rgba & 0xFF;
+        float x1 = x + SIZE, y1 = y + SIZE;
+        Hud::Vertex quad[6] = {
+            { x, y, 0.0f, 0.0f, r, g, b, a }, { x1, y, 1.0f, 0.0f, r, g, b, a }, { x1, y1, 1.0f, 1.0f, r, g, b, a },
+            { x1, y1, 1.0f, 1.0f, r, g, b, a }, { x, y1, 0.0f, 1.0f, r, g, b, a }, { x, y, 0.0f, 0.0f, r, g, b, a }
+        };
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &vbo);
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Hud::Vertex), (void*)offsetof(Hud::Vertex, x));
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Hud::Vertex), (void*)offsetof(Hud::Vertex, u));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Hud::Vertex), (void*)offsetof(Hud::Vertex, r));
+        glEnableVertexAttribArray(2);
+    }
+
+    void destroy() {
+        glDeleteTextures(1, &texture);
+        glDeleteVertexArrays(1, &vao);
+        glDeleteBuffers(1, &vbo);
+        texture = vao = vbo = 0;
+    }
+
+    // Đánh dấu các điểm (toạ độ pixel minimap, ví dụ kết quả Bresenham); điểm ngoài minimap bị bỏ qua
+    void plot(const vector<Vec3>& points) {
+        for (const Vec3& p : points) {
+            int x0 = max((int)p.x - DOT / 2, 0), x1 = min((int)p.x - DOT / 2 + DOT, SIZE);
+            int y0 = max((int)p.y - DOT / 2, 0), y1 = min((int)p.y - DOT / 2 + DOT, SIZE);
+            for (int y = y0; y < y1; ++y) {
+                for (int x = x0; x < x1; ++x) {
+                    uint8_t& cell = bitmap[y * SIZE + x];
+                    if (cell) continue;
+                    cell = 255;
+                    dirtyMinX = min(dirtyMinX, x);
+                    dirtyMinY = min(dirtyMinY, y);
+                    dirtyMaxX = max(dirtyMaxX, x);
+                    dirtyMaxY = max(dirtyMaxY, y);
+                }
+            }
+        }
+    }
+
+    // Upload vùng bẩn (nếu có) rồi vẽ quad; gọi khi blend đã bật
+    // Texture gắn vào unit 1 giống atlas của HUD nên dùng lại được shader UI_HUD
+    void draw(GLStateCache& state, Shader& shader, const Mat4& projection) {
+        state.activeTexture(GL_TEXTURE1);
+        state.bindTexture(GL_TEXTURE_2D, texture);
+        if (dirtyMaxX >= dirtyMinX) {
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, SIZE);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, dirtyMinX, dirtyMinY, dirtyMaxX - dirtyMinX + 1, dirtyMaxY - dirtyMinY + 1,
+                            GL_RED, GL_UNSIGNED_BYTE, &bitmap[dirtyMinY * SIZE + dirtyMinX]);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            clearDirty();
+        }
+        state.useProgram(shader.ID);
+        shader.setMat4("projection", projection);
+        state.bindVertexArray(vao);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+    }
+
+    size_t memoryBytes() const { return bitmap.size(); }
+
+private:
+    unsigned int vao = 0, vbo = 0;
+    vector<uint8_t> bitmap; // Hàng 0 ở đáy minimap (trùng quy ước texture của GL)
+    int dirtyMinX, dirtyMinY, dirtyMaxX, dirtyMaxY;
+
+    void clearDirty() {
+        dirtyMinX = dirtyMinY = SIZE;
+        dirtyMaxX = dirtyMaxY = -1;
+    }
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+using namespace std;
+
+// Số luồng dùng cho các tác vụ bake (ít nhất 1)
+inline int workerCount() {
+    unsigned int n = thread::hardware_concurrency();
+    return n == 0 ? 1 : (int)n;
+}
+
+// Chia đoạn [begin, end) thành các khối liên tiếp, mỗi luồng xử lý một khối
+// fn(blockBegin, blockEnd) được gọi đồng thời trên nhiều luồng
+template <typename Fn>
+void parallelFor(int begin, int end, Fn fn) {
+    int count = end - begin;
+    if (count <= 0) return;
+    int threads = min(workerCount(), count);
+    if (threads == 1) {
+        fn(begin, end);
+        return;
+    }
+
+    int chunk = (count + threads - 1) / threads;
+    vector<thread> pool;
+    pool.reserve(threads - 1);
+    // Luồng gọi cũng tham gia xử lý khối đầu tiên
+    for (int t = 1; t < threads; ++t) {
+        int b = begin + t * chunk;
+        int e = min(end, b + chunk);
+        if (b >= e) break;
+        pool.emplace_back(fn, b, e);
+    }
+    fn(begin, min(end, begin + chunk));
+    for (auto& th : pool) th.join();
+}
+
+#endif
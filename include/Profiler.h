@@ -0,0 +1,156 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "Logger.h"
+
+// Profiler CPU theo vùng (zone) lồng nhau:
+//  - PROFILE_ZONE("tên") đo từ chỗ khai báo tới cuối scope (RAII)
+//  - Mỗi luồng ghi vào ring buffer riêng (thread_local) - không khóa, không cấp phát trên đường nóng
+//  - Tắt lúc chạy (mặc định): mỗi zone chỉ tốn một lần đọc cờ; build với TERRAIN_DISABLE_PROFILER thì xoá hẳn
+//  - writeChromeTrace() xuất trace_event JSON, mở bằng chrome://tracing hoặc ui.perfetto.dev
+class Profiler {
+public:
+    struct Event {
+        const char* name; // Chuỗi hằng (literal) - chỉ lưu con trỏ
+        int64_t startNs, endNs; // endNs < 0: event counter, giá trị nằm trong value
+        double value;
+    };
+
+    class Zone {
+    public:
+        explicit Zone(const char* name) : name(name), startNs(Profiler::isEnabled() ? Profiler::nowNs() : -1) {}
+        ~Zone() {
+            if (startNs >= 0) Profiler::record(name, startNs, Profiler::nowNs());
+        }
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+
+    private:
+        const char* name;
+        int64_t startNs;
+    };
+
+    // Số event giữ lại mỗi luồng; cũ hơn bị ghi đè
+    static const uint32_t RING_CAPACITY = 1 << 16;
+
+    static void enable(bool on) { enabledFlag.store(on, memory_order_relaxed); }
+    static bool isEnabled() { return enabledFlag.load(memory_order_relaxed); }
+
+    static int64_t nowNs() {
+        return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - origin).count();
+    }
+
+    static void record(const char* name, int64_t startNs, int64_t endNs) {
+        ThreadBuffer& buffer = local();
+        uint64_t head = buffer.head.load(memory_order_relaxed);
+        buffer.events[head & (RING_CAPACITY - 1)] = { name, startNs, endNs, 0.0 };
+        buffer.head.store(head + 1, memory_order_release);
+    }
+
+    // Giá trị theo thời gian (hiện thành biểu đồ riêng trong trace), ví dụ thời gian GPU của một pass
+    static void counter(const char* name, double value) {
+        if (!isEnabled()) return;
+        ThreadBuffer& buffer = local();
+        uint64_t head = buffer.head.load(memory_order_relaxed);
+        buffer.events[head & (RING_CAPACITY - 1)] = { name, nowNs(), -1, value };
+        buffer.head.store(head + 1, memory_order_release);
+    }
+
+    // Tên hiển thị của luồng hiện tại trong trace
+    static void setThreadName(const char* name) { local().name = name; }
+
+    // Nên gọi khi các luồng khác không còn ghi (cuối chương trình, giữa hai frame...)
+    static bool writeChromeTrace(const string& path) {
+        FILE* out = fopen(path.c_str(), "w");
+        if (!out) {
+            LOG_ERROR("ERROR::PROFILER::CANNOT_WRITE: " << path);
+            return false;
+        }
+        fprintf(out, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+        bool first = true;
+        lock_guard<mutex> lock(registryGuard);
+        for (const unique_ptr<ThreadBuffer>& buffer : registry()) {
+            fprintf(out, "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %u, \"args\": {\"name\": \"",
+                    first ? "" : ",\n", buffer->tid);
+            writeEscaped(out, buffer->name.c_str());
+            fprintf(out, "\"}}");
+            first = false;
+
+            uint64_t head = buffer->head.load(memory_order_acquire);
+            uint64_t begin = head > RING_CAPACITY ? head - RING_CAPACITY : 0;
+            for (uint64_t i = begin; i < head; ++i) {
+                const Event& e = buffer->events[i & (RING_CAPACITY - 1)];
+                fprintf(out, ",\n{\"name\": \"");
+                writeEscaped(out, e.name);
+                if (e.endNs < 0)
+                    fprintf(out, "\", \"ph\": \"C\", \"pid\": 1, \"tid\": %u, \"ts\": %.3f, \"args\": {\"value\": %.6g}}",
+                            buffer->tid, e.startNs / 1000.0, e.value);
+                else
+                    fprintf(out, "\", \"cat\": \"cpu\", \"ph\": \"X\", \"pid\": 1, \"tid\": %u, \"ts\": %.3f, \"dur\": %.3f}",
+                            buffer->tid, e.startNs / 1000.0, (e.endNs - e.startNs) / 1000.0);
+            }
+        }
+        fprintf(out, "\n]}\n");
+        return fclose(out) == 0;
+    }
+
+private:
+    struct ThreadBuffer {
+        vector<Event> events;
+        atomic<uint64_t> head{ 0 };
+        uint32_t tid = 0;
+        string name;
+    };
+
+    static inline atomic<bool> enabledFlag{ false };
+    static inline const chrono::steady_clock::time_point origin = chrono::steady_clock::now();
+    static inline mutex registryGuard;
+
+    // Buffer thuộc registry (không thuộc luồng) nên vẫn xuất được sau khi luồng đã kết thúc
+    static vector<unique_ptr<ThreadBuffer>>& registry() {
+        static vector<unique_ptr<ThreadBuffer>> buffers;
+        return buffers;
+    }
+
+    static ThreadBuffer& local() {
+        thread_local ThreadBuffer* buffer = registerThread();
+        return *buffer;
+    }
+
+    static ThreadBuffer* registerThread() {
+        unique_ptr<ThreadBuffer> buffer(new ThreadBuffer());
+        buffer->events.resize(RING_CAPACITY);
+        lock_guard<mutex> lock(registryGuard);
+        buffer->tid = (uint32_t)registry().size() + 1;
+        buffer->name = "thread " + to_string(buffer->tid);
+        registry().push_back(move(buffer));
+        return registry().back().get();
+    }
+
+    static void writeEscaped(FILE* out, const char* s) {
+        for (; *s; ++s) {
+            if (*s == '"' || *s == '\\') fputc('\\', out);
+            fputc(*s, out);
+        }
+    }
+};
+
+#if defined(TERRAIN_DISABLE_PROFILER)
+#define PROFILE_ZONE(name)
+#else
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) Profiler::Zone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#endif
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef PROGRAM_BINARY_CACHE_H
+#define PROGRAM_BINARY_CACHE_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "GLExtensions.h"
+#include "Logger.h"
+
+// Cache program đã link ra đĩa (glGetProgramBinary/glProgramBinary) để bỏ qua compile + link GLSL
+// Mỗi program một file, key gồm hash mã nguồn (đã chèn define) + vendor/renderer/version của driver:
+// đổi shader hoặc đổi driver đều sinh key mới, file cũ không bao giờ được dùng nhầm
+class ProgramBinaryCache {
+public:
+    static inline string directory = "shader_cache";
+
+    static bool available() { return GLExtensions::programBinary; }
+
+    static string makeKey(const string& vertexCode, const string& fragmentCode) {
+        string key;
+        key += glString(GL_VENDOR);
+        key += '\n';
+        key += glString(GL_RENDERER);
+        key += '\n';
+        key += glString(GL_VERSION);
+        key += '\n';
+        key += toHex(fnv1a64(vertexCode));
+        key += toHex(fnv1a64(fragmentCode));
+        return key;
+    }
+
+    // Phải gọi trước glLinkProgram để driver giữ lại binary
+    static void prepare(unsigned int program) {
+        if (available()) GLExtensions::programParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
+    // true nếu nạp được binary và program link thành công; sai lệch bất kỳ -> người gọi compile từ nguồn
+    static bool load(unsigned int program, const string& key) {
+        if (!available()) return false;
+        ifstream file(pathFor(key), ios::binary | ios::ate);
+        if (!file.is_open()) return false;
+        uint64_t fileBytes = (uint64_t)file.tellg();
+        file.seekg(0);
+
+        Header header;
+        if (!file.read((char*)&header, sizeof(header)) || header.magic != MAGIC || header.version != VERSION ||
+            header.keyLength != key.size())
+            return false;
+        // save() ghi đúng header + key + binary: độ dài khác kích thước file là file hỏng/cắt cụt,
+        // bỏ qua trước khi cấp phát (không tin binaryLength trong file)
+        if (header.binaryLength == 0 ||
+            fileBytes != (uint64_t)sizeof(header) + header.keyLength + header.binaryLength) {
+            LOG_WARN("Program binary cache entry is corrupt, compiling from source: " << pathFor(key));
+            return false;
+        }
+        string storedKey(header.keyLength, '\0');
+        vector<char> binary(header.binaryLength);
+        if (!file.read(&storedKey[0], storedKey.size()) || storedKey != key ||
+            !file.read(binary.data(), binary.size()))
+            return false;
+
+        GLExtensions::programBinaryLoad(program, header.format, binary.data(), (GLsizei)binary.size());
+        int success = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        return success != 0;
+    }
+
+    static bool save(unsigned int program, const string& key) {
+        if (!available()) return false;
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0) return false;
+
+        vector<char> binary(length);
+        GLenum format = 0;
+        GLsizei written = 0;
+        GLExtensions::getProgramBinary(program, length, &written, &format, binary.data());
+        if (written <= 0) return false;
+
+        error_code ec;
+        filesystem::create_directories(directory, ec);
+        ofstream file(pathFor(key), ios::binary | ios::trunc);
+        if (!file.is_open()) {
+            LOG_ERROR("ERROR::PROGRAM_BINARY_CACHE::CANNOT_WRITE: " << pathFor(key));
+            return false;
+        }
+
+        Header header;
+        header.magic = MAGIC;
+        header.version = VERSION;
+        header.format = format;
+        header.keyLength = (uint32_t)key.size();
+        header.binaryLength = (uint32_t)written;
+        file.write((const char*)&header, sizeof(header));
+        file.write(key.data(), key.size());
+        file.write(binary.data(), written);
+        return (bool)file;
+    }
+
+private:
+    static const uint32_t MAGIC = 0x42475250; // "PRGB"
+    static const uint32_t VERSION = 1;
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t format;
+        uint32_t keyLength, binaryLength;
+    };
+
+    static string pathFor(const string& key) { return directory + "/" + toHex(fnv1a64(key)) + ".bin"; }
+
+    static string glString(GLenum name) {
+        const char* s = (const char*)glGetString(name);
+        return s ? s : "";
+    }
+
+    static uint64_t fnv1a64(const string& s) {
+        uint64_t h = 14695981039346656037ull;
+        for (unsigned char c : s) h = (h ^ c) * 1099511628211ull;
+        return h;
+    }
+
+    static string toHex(uint64_t v) {
+        static const char digits[] = "0123456789abcdef";
+        string out(16, '0');
+        for (int i = 15; i >= 0; --i, v >>= 4) out[i] = digits[v & 0xF];
+        return out;
+    }
+};
+
+#endif
@@ -2,120 +2,227 @@
 #define SHADER_H
 
 #include <glad/glad.h>
+#include <cstring>
 #include <string>
-#include <fstream>
-#include <sstream>
-#include <iostream>
+#include <vector>
 using namespace std;
 
 #include "Math3D.h"
+#include "Logger.h"
+#include "UniformCache.h"
+#include "ProgramBinaryCache.h"
+#include "ShaderSources.h"
 
 class Shader {
 public:
     unsigned int ID;
+    bool fromBinaryCache = false; // true nếu program được nạp từ ProgramBinaryCache thay vì compile
 
-    Shader(const char* vertexPath, const char* fragmentPath) {
+    // Tag: chỉ gửi lệnh compile + link rồi trả về ngay, gọi finishLink() trước lần dùng đầu tiên.
+    // Với KHR_parallel_shader_compile driver compile trên luồng riêng trong lúc CPU làm việc khác
+    struct DeferLink {};
+
+    // Tag: dựng từ mã GLSL trong bộ nhớ thay vì đường dẫn
+    struct FromSource {};
+
+    // defines: các dòng "#define ..." chèn ngay sau #version ở cả hai stage (shader permutation)
+    // Đường dẫn được tra trong bản nhúng trước, xem ShaderSources
+    Shader(const char* vertexPath, const char* fragmentPath, const string& defines = "")
+        : Shader(vertexPath, fragmentPath, defines, DeferLink()) {
+        finishLink();
+    }
+
+    Shader(const char* vertexPath, const char* fragmentPath, const string& defines, DeferLink) {
         ID = 0;
-        // 1. Retrieve code from file
+        // 1. Retrieve code (bản nhúng hoặc file)
         string vertexCode;
         string fragmentCode;
-        ifstream vShaderFile;
-        ifstream fShaderFile;
-        
-        vShaderFile.exceptions(ifstream::failbit | ifstream::badbit);
-        fShaderFile.exceptions(ifstream::failbit | ifstream::badbit);
-        try {
-            vShaderFile.open(vertexPath);
-            fShaderFile.open(fragmentPath);
-            if (!vShaderFile.is_open()) {
-                cout << "ERROR::SHADER::FILE_NOT_FOUND: " << vertexPath << endl;
-                return;
-            }
-            if (!fShaderFile.is_open()) {
-                cout << "ERROR::SHADER::FILE_NOT_FOUND: " << fragmentPath << endl;
-                return;
-            }
-            stringstream vShaderStream, fShaderStream;
-            vShaderStream << vShaderFile.rdbuf();
-            fShaderStream << fShaderFile.rdbuf();
-            vShaderFile.close();
-            fShaderFile.close();
-            vertexCode = vShaderStream.str();
-            fragmentCode = fShaderStream.str();
-            
-            if (vertexCode.empty()) {
-                cout << "ERROR::SHADER::VERTEX_SHADER_IS_EMPTY: " << vertexPath << endl;
-                return;
-            }
-            if (fragmentCode.empty()) {
-                cout << "ERROR::SHADER::FRAGMENT_SHADER_IS_EMPTY: " << fragmentPath << endl;
-                return;
-            }
-        } catch (ifstream::failure& e) {
-            cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << endl;
-            cout << "  Vertex path: " << vertexPath << endl;
-            cout << "  Fragment path: " << fragmentPath << endl;
-            cout << "  Error: " << e.what() << endl;
+        if (!ShaderSources::load(vertexPath, vertexCode)) {
+            LOG_ERROR("ERROR::SHADER::FILE_NOT_FOUND: " << ShaderSources::diskPath(vertexPath));
             return;
         }
-        const char* vShaderCode = vertexCode.c_str();
-        const char * fShaderCode = fragmentCode.c_str();
-        
-        // 2. Compile
-        unsigned int vertex, fragment;
-        vertex = glCreateShader(GL_VERTEX_SHADER);
-        glShaderSource(vertex, 1, &vShaderCode, NULL);
-        glCompileShader(vertex);
-        if (!checkCompileErrors(vertex, "VERTEX")) {
-            glDeleteShader(vertex);
-            return;
-        }
-        
-        fragment = glCreateShader(GL_FRAGMENT_SHADER);
-        glShaderSource(fragment, 1, &fShaderCode, NULL);
-        glCompileShader(fragment);
-        if (!checkCompileErrors(fragment, "FRAGMENT")) {
-            glDeleteShader(vertex);
-            glDeleteShader(fragment);
+        if (!ShaderSources::load(fragmentPath, fragmentCode)) {
+            LOG_ERROR("ERROR::SHADER::FILE_NOT_FOUND: " << ShaderSources::diskPath(fragmentPath));
             return;
         }
-        
-        // Shader Program
-        ID = glCreateProgram();
-        glAttachShader(ID, vertex);
-        glAttachShader(ID, fragment);
-        glLinkProgram(ID);
-        if (!checkCompileErrors(ID, "PROGRAM")) {
-            glDeleteShader(vertex);
-            glDeleteShader(fragment);
+        init(vertexCode, fragmentCode, defines, vertexPath, fragmentPath);
+    }
+
+    Shader(FromSource, const string& vertexCode, const string& fragmentCode, const string& defines = "")
+        : Shader(FromSource(), vertexCode, fragmentCode, defines, DeferLink()) {
+        finishLink();
+    }
+
+    Shader(FromSource, const string& vertexCode, const string& fragmentCode, const string& defines, DeferLink) {
+        ID = 0;
+        init(vertexCode, fragmentCode, defines, "<memory>", "<memory>");
+    }
+
+    // true khi finishLink() sẽ không phải chờ driver (luôn true nếu không có KHR_parallel_shader_compile)
+    bool isReady() const {
+        if (!linkPending || !GLExtensions::parallelShaderCompile) return true;
+        int done = 0;
+        glGetProgramiv(ID, GL_COMPLETION_STATUS_KHR, &done);
+        return done != 0;
+    }
+
+    // Kiểm tra lỗi compile/link, lưu binary vào cache, đọc sẵn uniform location
+    bool finishLink() {
+        if (!linkPending) return ID != 0;
+        linkPending = false;
+
+        bool ok = checkCompileErrors(pendingVertex, "VERTEX") &&
+                  checkCompileErrors(pendingFragment, "FRAGMENT") &&
+                  checkCompileErrors(ID, "PROGRAM");
+        glDeleteShader(pendingVertex);
+        glDeleteShader(pendingFragment);
+        pendingVertex = pendingFragment = 0;
+        if (!ok) {
             glDeleteProgram(ID);
             ID = 0;
-            return;
+            return false;
         }
-        
-        glDeleteShader(vertex);
-        glDeleteShader(fragment);
+
+        if (!pendingBinaryKey.empty()) ProgramBinaryCache::save(ID, pendingBinaryKey);
+        pendingBinaryKey.clear();
+        cacheActiveUniforms();
+        return true;
     }
     
     void use() { glUseProgram(ID); }
+
+    // Gắn uniform block (std140) của program vào binding point dùng chung
+    // GLSL 330 chưa có layout(binding = N) nên phải gắn từ phía C++ sau khi link
+    bool bindUniformBlock(const char* blockName, unsigned int binding) const {
+        unsigned int index = glGetUniformBlockIndex(ID, blockName);
+        if (index == GL_INVALID_INDEX) {
+            LOG_ERROR("ERROR::SHADER::UNIFORM_BLOCK_NOT_FOUND: " << blockName);
+            return false;
+        }
+        glUniformBlockBinding(ID, index, binding);
+        return true;
+    }
+
+    // Location lấy từ cache; tên chưa gặp (ví dụ uniform không active) mới hỏi driver, một lần
+    int uniformLocation(UniformName name) const {
+        int location;
+        if (uniforms.find(name, location)) return location;
+        location = glGetUniformLocation(ID, name.str);
+        uniforms.insert(name, location);
+        return location;
+    }
     
-    void setMat4(const string &name, const Mat4 &mat) const {
-        glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, mat.value_ptr());
+    void setMat4(UniformName name, const Mat4 &mat) const {
+        glUniformMatrix4fv(uniformLocation(name), 1, GL_FALSE, mat.value_ptr());
     }
     
-    void setVec3(const string &name, const Vec3 &value) const {
-        glUniform3f(glGetUniformLocation(ID, name.c_str()), value.x, value.y, value.z);
+    void setMat3(UniformName name, const Mat3 &mat) const {
+        glUniformMatrix3fv(uniformLocation(name), 1, GL_FALSE, mat.value_ptr());
     }
     
-    void setInt(const string &name, int value) const {
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+    void setVec3(UniformName name, const Vec3 &value) const {
+        glUniform3f(uniformLocation(name), value.x, value.y, value.z);
     }
     
-    void setFloat(const string &name, float value) const {
-        glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+    void setInt(UniformName name, int value) const {
+        glUniform1i(uniformLocation(name), value);
+    }
+    
+    void setFloat(UniformName name, float value) const {
+        glUniform1f(uniformLocation(name), value);
+    }
+
+    // #version phải là dòng đầu tiên nên define được chèn ngay sau nó
+    static string injectDefines(const string& source, const string& defines) {
+        size_t insertAt = 0;
+        if (source.compare(0, 8, "#version") == 0) {
+            size_t eol = source.find('\n');
+            insertAt = (eol == string::npos) ? source.size() : eol + 1;
+        }
+        return source.substr(0, insertAt) + defines + source.substr(insertAt);
     }
 
 private:
+    mutable UniformCache uniforms;
+
+    // Trạng thái giữa lúc gửi compile và finishLink()
+    bool linkPending = false;
+    unsigned int pendingVertex = 0, pendingFragment = 0;
+    string pendingBinaryKey;
+
+    void init(string vertexCode, string fragmentCode, const string& defines, const char* vertexName,
+              const char* fragmentName) {
+        if (vertexCode.empty()) {
+            LOG_ERROR("ERROR::SHADER::VERTEX_SHADER_IS_EMPTY: " << vertexName);
+            return;
+        }
+        if (fragmentCode.empty()) {
+            LOG_ERROR("ERROR::SHADER::FRAGMENT_SHADER_IS_EMPTY: " << fragmentName);
+            return;
+        }
+        if (!defines.empty()) {
+            vertexCode = injectDefines(vertexCode, defines);
+            fragmentCode = injectDefines(fragmentCode, defines);
+        }
+        submit(vertexCode, fragmentCode);
+    }
+
+    void submit(const string& vertexCode, const string& fragmentCode) {
+        // 2. Thử nạp program binary đã cache từ lần chạy trước (bỏ qua compile + link)
+        string binaryKey;
+        if (ProgramBinaryCache::available()) {
+            binaryKey = ProgramBinaryCache::makeKey(vertexCode, fragmentCode);
+            ID = glCreateProgram();
+            if (ProgramBinaryCache::load(ID, binaryKey)) {
+                fromBinaryCache = true;
+                cacheActiveUniforms();
+                return;
+            }
+            glDeleteProgram(ID);
+            ID = 0;
+        }
+
+        const char* vShaderCode = vertexCode.c_str();
+        const char * fShaderCode = fragmentCode.c_str();
+
+        // 3. Compile + link - không truy vấn trạng thái ở đây để driver có thể làm song song
+        pendingVertex = glCreateShader(GL_VERTEX_SHADER);
+        glShaderSource(pendingVertex, 1, &vShaderCode, NULL);
+        glCompileShader(pendingVertex);
+
+        pendingFragment = glCreateShader(GL_FRAGMENT_SHADER);
+        glShaderSource(pendingFragment, 1, &fShaderCode, NULL);
+        glCompileShader(pendingFragment);
+
+        // Shader Program
+        ID = glCreateProgram();
+        glAttachShader(ID, pendingVertex);
+        glAttachShader(ID, pendingFragment);
+        ProgramBinaryCache::prepare(ID);
+        glLinkProgram(ID);
+
+        pendingBinaryKey = binaryKey;
+        linkPending = true;
+    }
+
+    // Sau khi link: đọc sẵn location của mọi uniform active vào cache
+    void cacheActiveUniforms() {
+        uniforms.clear();
+        int count = 0;
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+        for (int i = 0; i < count; ++i) {
+            char name[256];
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(ID, (GLuint)i, sizeof(name), &length, &size, &type, name);
+            // Mảng được báo là "tên[0]" - lưu theo tên gốc để setX("tên") trúng cache
+            if (length > 3 && strcmp(name + length - 3, "[0]") == 0) name[length -= 3] = '\0';
+
+            uniforms.insert(UniformName(name, length), glGetUniformLocation(ID, name));
+        }
+    }
+
     bool checkCompileErrors(unsigned int shader, string type) {
         int success;
         char infoLog[1024];
@@ -123,18 +230,72 @@ private:
             glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
             if (!success) {
                 glGetShaderInfoLog(shader, 1024, NULL, infoLog);
-                cout << "ERROR::SHADER_COMPILATION_ERROR of type: " << type << "\n" << infoLog << endl;
+                LOG_ERROR("ERROR::SHADER_COMPILATION_ERROR of type: " << type << "\n" << infoLog);
                 return false;
             }
         } else {
             glGetProgramiv(shader, GL_LINK_STATUS, &success);
             if (!success) {
                 glGetProgramInfoLog(shader, 1024, NULL, infoLog);
-                cout << "ERROR::PROGRAM_LINKING_ERROR of type: " << type << "\n" << infoLog << endl;
+                LOG_ERROR("ERROR::PROGRAM_LINKING_ERROR of type: " << type << "\n" << infoLog);
                 return false;
             }
         }
         return true;
     }
 };
+
+//  Tập biến thể của một cặp shader, mỗi key (ví dụ tổ hợp chế độ hiển thị) ứng với một bộ #define
+// Các key có bộ define giống hệt nhau dùng chung một program - chỉ biên dịch một lần
+class ShaderPermutations {
+public:
+    ShaderPermutations(const char* vertexPath, const char* fragmentPath, const vector<string>& definesPerKey)
+        : ShaderPermutations(vertexPath, fragmentPath, definesPerKey, Shader::DeferLink()) {
+        finishLink();
+    }
+
+    // Gửi compile mọi biến thể rồi trả về ngay; gọi finishLink() trước khi dùng
+    ShaderPermutations(const char* vertexPath, const char* fragmentPath, const vector<string>& definesPerKey,
+                       Shader::DeferLink) {
+        variantOfKey.resize(definesPerKey.size());
+        for (size_t key = 0; key < definesPerKey.size(); ++key) {
+            size_t v = 0;
+            while (v < variantDefines.size() && variantDefines[v] != definesPerKey[key]) ++v;
+            if (v == variantDefines.size()) {
+                variantDefines.push_back(definesPerKey[key]);
+                variants.push_back(Shader(vertexPath, fragmentPath, definesPerKey[key], Shader::DeferLink()));
+            }
+            variantOfKey[key] = v;
+        }
+    }
+
+    bool isReady() const {
+        for (const Shader& shader : variants)
+            if (!shader.isReady()) return false;
+        return true;
+    }
+
+    bool finishLink() {
+        bool ok = true;
+        for (Shader& shader : variants) ok = shader.finishLink() && ok;
+        return ok;
+    }
+
+    Shader& get(size_t key) { return variants[variantOfKey[key]]; }
+
+    // Thiết lập dùng chung cho mọi biến thể (sampler, uniform block...)
+    template <typename Fn>
+    void forEach(Fn fn) {
+        for (Shader& shader : variants) fn(shader);
+    }
+
+    size_t variantCount() const { return variants.size(); }
+    Shader& variant(size_t v) { return variants[v]; }
+    const string& definesOf(size_t v) const { return variantDefines[v]; }
+
+private:
+    vector<Shader> variants;
+    vector<string> variantDefines;
+    vector<size_t> variantOfKey;
+};
 #endif
\ No newline at end of file
@@ -0,0 +1,234 @@
+#ifndef SHADER_HOT_RELOAD_H
+#define SHADER_HOT_RELOAD_H
+
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+#if defined(__linux__)
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include "Logger.h"
+#include "Shader.h"
+#include "ShaderSources.h"
+
+// Chế độ phát triển: theo dõi thư mục shader bằng inotify và compile lại shader vừa được sửa khi đang chạy
+// (kể cả shader #include file .glsl vừa được sửa)
+//  - Luồng watcher: chờ sự kiện, đọc file và chèn define - không đụng tới GL
+//  - Luồng render (update() mỗi frame): chỉ gửi lệnh compile (DeferLink) rồi quay lại vẽ; program mới thay
+//    program cũ khi link xong và thành công, lỗi thì giữ program cũ
+// Với KHR_parallel_shader_compile frame không phải chờ compile; driver không hỗ trợ thì finishLink() chặn
+// một lần ngay frame nhận bản sửa
+class ShaderHotReload {
+public:
+    ShaderHotReload() = default;
+    ShaderHotReload(const ShaderHotReload&) = delete;
+    ShaderHotReload& operator=(const ShaderHotReload&) = delete;
+    ~ShaderHotReload() { stop(); }
+
+    // Đăng ký trước start(). setup chạy lại trên program mới (uniform block, sampler...)
+    void watch(Shader& shader, const char* vertexPath, const char* fragmentPath, const string& defines = "",
+               function<void(Shader&)> setup = nullptr) {
+        entries.push_back({ &shader, ShaderSources::fileName(vertexPath), ShaderSources::fileName(fragmentPath),
+                            defines, setup });
+    }
+
+    void watch(ShaderPermutations& permutations, const char* vertexPath, const char* fragmentPath,
+               function<void(Shader&)> setup = nullptr) {
+        for (size_t v = 0; v < permutations.variantCount(); ++v)
+            watch(permutations.variant(v), vertexPath, fragmentPath, permutations.definesOf(v), setup);
+    }
+
+    bool start(const string& watchDirectory) {
+#if defined(__linux__)
+        directory = watchDirectory;
+        // Đọc trước danh sách #include của từng shader: sửa file .glsl chỉ compile lại shader dùng nó
+        for (Entry& entry : entries) {
+            string code;
+            ShaderSources::loadFromDirectory(directory, entry.vertexFile, code, &entry.includes);
+            ShaderSources::loadFromDirectory(directory, entry.fragmentFile, code, &entry.includes);
+        }
+        inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        // Editor thường ghi file tạm rồi rename -> cần cả IN_MOVED_TO ngoài IN_CLOSE_WRITE
+        if (inotifyFd < 0 || inotify_add_watch(inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0 ||
+            pipe2(stopPipe, O_CLOEXEC) != 0) {
+            LOG_ERROR("ERROR::SHADER_HOT_RELOAD::CANNOT_WATCH: " << directory);
+            closeDescriptors();
+            return false;
+        }
+        watcher = thread(&ShaderHotReload::watchLoop, this);
+        return true;
+#else
+        (void)watchDirectory;
+        LOG_ERROR("ERROR::SHADER_HOT_RELOAD::UNSUPPORTED_PLATFORM");
+        return false;
+#endif
+    }
+
+    void stop() {
+#if defined(__linux__)
+        if (watcher.joinable()) {
+            char wake = 0;
+            if (write(stopPipe[1], &wake, 1) < 0) LOG_ERROR("ERROR::SHADER_HOT_RELOAD::CANNOT_STOP");
+            watcher.join();
+        }
+        closeDescriptors();
+#endif
+    }
+
+    // Gọi mỗi frame trên luồng có GL context; trả về số program vừa được thay
+    int update() {
+        vector<PreparedSource> jobs;
+        {
+            // Watcher đang giữ khóa thì để frame sau, không bao giờ chờ
+            unique_lock<mutex> lock(guard, try_to_lock);
+            if (lock.owns_lock()) jobs.swap(prepared);
+        }
+        for (PreparedSource& job : jobs)
+            pending.push_back({ job.entry, Shader(Shader::FromSource(), job.vertexCode, job.fragmentCode, "",
+                                                  Shader::DeferLink()) });
+
+        int swapped = 0;
+        for (size_t k = 0; k < pending.size();) {
+            if (!pending[k].shader.isReady()) {
+                ++k;
+                continue;
+            }
+            Entry& entry = entries[pending[k].entry];
+            if (pending[k].shader.finishLink()) {
+                glDeleteProgram(entry.target->ID);
+                *entry.target = pending[k].shader;
+                if (entry.setup) entry.setup(*entry.target);
+                LOG_INFO("Shader reloaded: " << entry.vertexFile << " + " << entry.fragmentFile);
+                ++swapped;
+            } else {
+                LOG_ERROR("ERROR::SHADER_HOT_RELOAD::KEEPING_PREVIOUS_PROGRAM: " << entry.vertexFile << " + "
+                          << entry.fragmentFile);
+            }
+            pending.erase(pending.begin() + k);
+        }
+        return swapped;
+    }
+
+private:
+    struct Entry {
+        Shader* target;
+        string vertexFile, fragmentFile;
+        string defines;
+        function<void(Shader&)> setup;
+        vector<string> includes; // File .glsl được #include lần đọc gần nhất (chỉ luồng watcher)
+    };
+
+    // Mã nguồn đã đọc + chèn define, chờ luồng render gửi compile
+    struct PreparedSource {
+        size_t entry;
+        string vertexCode, fragmentCode;
+    };
+
+    struct PendingLink {
+        size_t entry;
+        Shader shader;
+    };
+
+    // Gom các lần ghi liên tiếp của editor thành một lần reload
+    static const int DEBOUNCE_MS = 50;
+
+    vector<Entry> entries;
+    string directory;
+    thread watcher;
+    mutex guard;
+    vector<PreparedSource> prepared; // guard
+    vector<PendingLink> pending;     // chỉ luồng render
+    int inotifyFd = -1;
+    int stopPipe[2] = { -1, -1 };
+
+#if defined(__linux__)
+    void watchLoop() {
+        pollfd fds[2] = { { inotifyFd, POLLIN, 0 }, { stopPipe[0], POLLIN, 0 } };
+        vector<string> changed;
+        while (true) {
+            int ready = poll(fds, 2, changed.empty() ? -1 : DEBOUNCE_MS);
+            if (ready < 0) {
+                if (errno == EINTR) continue;
+                LOG_ERROR("ERROR::SHADER_HOT_RELOAD::POLL_FAILED");
+                return;
+            }
+            if (fds[1].revents) return;
+            if (ready == 0) {
+                prepareChanged(changed);
+                changed.clear();
+                continue;
+            }
+            readEvents(changed);
+        }
+    }
+
+    void readEvents(vector<string>& changed) {
+        alignas(inotify_event) char buffer[4096];
+        ssize_t length;
+        while ((length = read(inotifyFd, buffer, sizeof(buffer))) > 0) {
+            for (char* p = buffer; p < buffer + length;) {
+                const inotify_event* event = (const inotify_event*)p;
+                if (event->len > 0) {
+                    string name(event->name);
+                    if (find(changed.begin(), changed.end(), name) == changed.end()) changed.push_back(name);
+                }
+                p += sizeof(inotify_event) + event->len;
+            }
+        }
+    }
+
+    static bool contains(const vector<string>& names, const string& name) {
+        return find(names.begin(), names.end(), name) != names.end();
+    }
+
+    void prepareChanged(const vector<string>& changed) {
+        for (size_t i = 0; i < entries.size(); ++i) {
+            Entry& entry = entries[i];
+            bool affected = contains(changed, entry.vertexFile) || contains(changed, entry.fragmentFile) ||
+                            any_of(entry.includes.begin(), entry.includes.end(),
+                                   [&](const string& name) { return contains(changed, name); });
+            if (!affected) continue;
+
+            PreparedSource job;
+            job.entry = i;
+            vector<string> includes;
+            if (!ShaderSources::loadFromDirectory(directory, entry.vertexFile, job.vertexCode, &includes) ||
+                !ShaderSources::loadFromDirectory(directory, entry.fragmentFile, job.fragmentCode, &includes)) {
+                LOG_ERROR("ERROR::SHADER_HOT_RELOAD::CANNOT_READ: " << entry.vertexFile << " + " << entry.fragmentFile);
+                continue;
+            }
+            // Shader vừa thêm/bỏ #include: lần sửa sau theo danh sách mới
+            entry.includes.swap(includes);
+            if (!entry.defines.empty()) {
+                job.vertexCode = Shader::injectDefines(job.vertexCode, entry.defines);
+                job.fragmentCode = Shader::injectDefines(job.fragmentCode, entry.defines);
+            }
+
+            lock_guard<mutex> lock(guard);
+            // Bản sửa mới hơn thay bản cũ chưa được luồng render nhận
+            auto old = find_if(prepared.begin(), prepared.end(), [&](const PreparedSource& p) { return p.entry == i; });
+            if (old != prepared.end()) *old = job;
+            else prepared.push_back(job);
+        }
+    }
+
+    void closeDescriptors() {
+        if (inotifyFd >= 0) close(inotifyFd);
+        if (stopPipe[0] >= 0) close(stopPipe[0]);
+        if (stopPipe[1] >= 0) close(stopPipe[1]);
+        inotifyFd = stopPipe[0] = stopPipe[1] = -1;
+    }
+#endif
+};
+
+#endif
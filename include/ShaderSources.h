@@ -0,0 +1,144 @@
+#ifndef SHADER_SOURCES_H
+#define SHADER_SOURCES_H
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "Logger.h"
+
+// Header sinh lúc build (cmake/EmbedShaders.cmake) khi bật EMBED_SHADERS
+#if defined(TERRAIN_EMBED_SHADERS)
+#include "EmbeddedShaders.h"
+#endif
+
+// Nơi lấy mã GLSL cho Shader:
+//  - Mặc định: bản nhúng trong binary (không đọc file, không phụ thuộc thư mục làm việc)
+//  - Biến môi trường TERRAIN_SHADER_DIR=<thư mục>: đọc <thư mục>/<tên file> từ đĩa để sửa shader khi phát triển
+//  - Build không nhúng hoặc shader không có trong bản nhúng: đọc đúng đường dẫn được truyền vào
+// Dòng `#include "tên.glsl"` (GLSL không có) được thay bằng nội dung file cùng thư mục, lấy theo cùng quy tắc
+class ShaderSources {
+public:
+    static const char* overrideDirectory() {
+        const char* dir = getenv("TERRAIN_SHADER_DIR");
+        return (dir && dir[0]) ? dir : NULL;
+    }
+
+    // Thư mục shader hot-reload theo dõi: TERRAIN_SHADER_DIR nếu có, không thì assets/ trong cây mã nguồn
+    // (CMake truyền TERRAIN_SOURCE_ASSETS_DIR; assets/ cạnh binary chỉ là bản chép lúc configure, sửa không có tác dụng)
+    static const char* editableDirectory() {
+        if (const char* dir = overrideDirectory()) return dir;
+#if defined(TERRAIN_SOURCE_ASSETS_DIR)
+        return TERRAIN_SOURCE_ASSETS_DIR;
+#else
+        return "assets";
+#endif
+    }
+
+    static bool load(const char* path, string& source) {
+        if (!loadRaw(path, source)) return false;
+        const char* slash = strrchr(path, '/');
+        string directory = slash ? string(path, slash - path) : ".";
+        return expandIncludes(source, [&](const string& name, string& included) {
+            return loadRaw((directory + "/" + name).c_str(), included);
+        });
+    }
+
+    // Như load() nhưng luôn đọc từ đĩa trong directory (shader hot-reload).
+    // includes khác NULL: thêm tên các file được #include (kể cả lồng nhau) để biết shader phụ thuộc file nào
+    static bool loadFromDirectory(const string& directory, const string& name, string& source,
+                                  vector<string>* includes = NULL) {
+        auto read = [&](const string& file, string& text) {
+            if (includes && find(includes->begin(), includes->end(), file) == includes->end()) includes->push_back(file);
+            return readFile(directory + "/" + file, text);
+        };
+        return readFile(directory + "/" + name, source) && expandIncludes(source, read);
+    }
+
+    // Thay từng dòng #include "tên" bằng nội dung file (đệ quy, tối đa MAX_INCLUDE_DEPTH tầng).
+    // Bọc bằng #line để số dòng trong lỗi compile khớp với file chứa dòng lỗi (file include đánh số source 1)
+    template <typename Reader>
+    static bool expandIncludes(string& source, Reader read, int depth = 0) {
+        string result;
+        size_t lineStart = 0;
+        int line = 1;
+        while (lineStart < source.size()) {
+            size_t lineEnd = source.find('\n', lineStart);
+            if (lineEnd == string::npos) lineEnd = source.size();
+            string text = source.substr(lineStart, lineEnd - lineStart);
+            size_t open, close;
+            if (text.compare(0, 9, "#include ") == 0 && (open = text.find('"')) != string::npos &&
+                (close = text.find('"', open + 1)) != string::npos) {
+                string name = text.substr(open + 1, close - open - 1);
+                string included;
+                if (depth >= MAX_INCLUDE_DEPTH || !read(name, included) || !expandIncludes(included, read, depth + 1)) {
+                    LOG_ERROR("ERROR::SHADER::INCLUDE_NOT_FOUND: " << name);
+                    return false;
+                }
+                result += "#line 1 1\n" + included;
+                if (!included.empty() && included.back() != '\n') result += '\n';
+                result += "#line " + to_string(line + 1) + " 0\n";
+            } else {
+                result.append(source, lineStart, lineEnd - lineStart);
+                if (lineEnd < source.size()) result += '\n';
+            }
+            lineStart = lineEnd + 1;
+            ++line;
+        }
+        source.swap(result);
+        return true;
+    }
+
+    // Đường dẫn thực sự trên đĩa của shader nếu đang đọc từ file (rỗng nếu dùng bản nhúng)
+    static string diskPath(const char* path) {
+        if (const char* dir = overrideDirectory()) return string(dir) + "/" + fileName(path);
+        string embedded;
+        if (findEmbedded(path, embedded)) return "";
+        return path;
+    }
+
+    static bool findEmbedded(const char* path, string& source) {
+#if defined(TERRAIN_EMBED_SHADERS)
+        for (const EmbeddedShader& shader : EMBEDDED_SHADERS) {
+            if (strcmp(shader.path, path) == 0) {
+                source = shader.source;
+                return true;
+            }
+        }
+#else
+        (void)path;
+        (void)source;
+#endif
+        return false;
+    }
+
+    static const int MAX_INCLUDE_DEPTH = 4;
+
+    static bool loadRaw(const char* path, string& source) {
+        if (const char* dir = overrideDirectory()) return readFile(string(dir) + "/" + fileName(path), source);
+        if (findEmbedded(path, source)) return true;
+        return readFile(path, source);
+    }
+
+    static bool readFile(const string& path, string& source) {
+        ifstream file(path, ios::binary);
+        if (!file.is_open()) return false;
+        stringstream stream;
+        stream << file.rdbuf();
+        source = stream.str();
+        return !file.bad();
+    }
+
+    // Tên file không kèm thư mục: "assets/terrain.frag" -> "terrain.frag"
+    static string fileName(const char* path) {
+        const char* slash = strrchr(path, '/');
+        return slash ? slash + 1 : path;
+    }
+};
+
+#endif
@@ -0,0 +1,199 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <cmath>
+#include <cstdint>
+
+// Lớp bọc SIMD float: SSE/AVX trên x86, NEON trên ARM, vô hướng cho các nền khác
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MATH3D_SSE 1
+#include <emmintrin.h>
+#if defined(__AVX__)
+#define MATH3D_AVX 1
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define MATH3D_NEON 1
+#include <arm_neon.h>
+#endif
+
+struct f32x4 {
+#if defined(MATH3D_SSE)
+    __m128 v;
+    f32x4() {}
+    f32x4(__m128 _v) : v(_v) {}
+    explicit f32x4(float s) : v(_mm_set1_ps(s)) {}
+    f32x4(float a, float b, float c, float d) : v(_mm_setr_ps(a, b, c, d)) {}
+
+    static f32x4 load(const float* p) { return _mm_load_ps(p); }   // p căn 16 byte
+    static f32x4 loadu(const float* p) { return _mm_loadu_ps(p); }
+    void store(float* p) const { _mm_store_ps(p, v); }
+    void storeu(float* p) const { _mm_storeu_ps(p, v); }
+
+    f32x4 operator+(f32x4 o) const { return _mm_add_ps(v, o.v); }
+    f32x4 operator-(f32x4 o) const { return _mm_sub_ps(v, o.v); }
+    f32x4 operator*(f32x4 o) const { return _mm_mul_ps(v, o.v); }
+    f32x4 operator/(f32x4 o) const { return _mm_div_ps(v, o.v); }
+    friend f32x4 min(f32x4 a, f32x4 b) { return _mm_min_ps(a.v, b.v); }
+    friend f32x4 max(f32x4 a, f32x4 b) { return _mm_max_ps(a.v, b.v); }
+    friend f32x4 sqrt(f32x4 a) { return _mm_sqrt_ps(a.v); }
+    // 1/sqrt xấp xỉ (12 bit) + một bước Newton-Raphson (~22 bit)
+    friend f32x4 rsqrt(f32x4 a) {
+        __m128 y = _mm_rsqrt_ps(a.v);
+        __m128 yy = _mm_mul_ps(_mm_mul_ps(a.v, y), y);
+        return _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), y), _mm_sub_ps(_mm_set1_ps(3.0f), yy));
+    }
+    // Bit i = bit dấu của làn i
+    friend int signMask(f32x4 a) { return _mm_movemask_ps(a.v); }
+    // Nhân bản làn L ra cả 4 làn (một shufps, không qua bộ nhớ)
+    template <int L> f32x4 broadcast() const { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(L, L, L, L)); }
+#elif defined(MATH3D_NEON)
+    float32x4_t v;
+    f32x4() {}
+    f32x4(float32x4_t _v) : v(_v) {}
+    explicit f32x4(float s) : v(vdupq_n_f32(s)) {}
+    f32x4(float a, float b, float c, float d) { float t[4] = {a, b, c, d}; v = vld1q_f32(t); }
+
+    static f32x4 load(const float* p) { return vld1q_f32(p); }
+    static f32x4 loadu(const float* p) { return vld1q_f32(p); }
+    void store(float* p) const { vst1q_f32(p, v); }
+    void storeu(float* p) const { vst1q_f32(p, v); }
+
+    f32x4 operator+(f32x4 o) const { return vaddq_f32(v, o.v); }
+    f32x4 operator-(f32x4 o) const { return vsubq_f32(v, o.v); }
+    f32x4 operator*(f32x4 o) const { return vmulq_f32(v, o.v); }
+#if defined(__aarch64__)
+    f32x4 operator/(f32x4 o) const { return vdivq_f32(v, o.v); }
+#else
+    f32x4 operator/(f32x4 o) const {
+        float32x4_t r = vrecpeq_f32(o.v);
+        r = vmulq_f32(vrecpsq_f32(o.v, r), r);
+        r = vmulq_f32(vrecpsq_f32(o.v, r), r);
+        return vmulq_f32(v, r);
+    }
+#endif
+    friend f32x4 min(f32x4 a, f32x4 b) { return vminq_f32(a.v, b.v); }
+    friend f32x4 max(f32x4 a, f32x4 b) { return vmaxq_f32(a.v, b.v); }
+    friend f32x4 rsqrt(f32x4 a) {
+        float32x4_t y = vrsqrteq_f32(a.v);
+        y = vmulq_f32(y, vrsqrtsq_f32(vmulq_f32(a.v, y), y));
+        return vmulq_f32(y, vrsqrtsq_f32(vmulq_f32(a.v, y), y));
+    }
+#if defined(__aarch64__)
+    friend f32x4 sqrt(f32x4 a) { return vsqrtq_f32(a.v); }
+#else
+    friend f32x4 sqrt(f32x4 a) { return a * rsqrt(a); }
+#endif
+#if defined(__aarch64__)
+    template <int L> f32x4 broadcast() const { return vdupq_laneq_f32(v, L); }
+#else
+    template <int L> f32x4 broadcast() const { return vdupq_n_f32(vgetq_lane_f32(v, L)); }
+#endif
+    friend int signMask(f32x4 a) {
+        static const int32_t shifts[4] = { 0, 1, 2, 3 };
+        uint32x4_t bits = vshlq_u32(vshrq_n_u32(vreinterpretq_u32_f32(a.v), 31), vld1q_s32(shifts));
+        uint32x2_t sum = vadd_u32(vget_low_u32(bits), vget_high_u32(bits));
+        return (int)vget_lane_u32(vpadd_u32(sum, sum), 0);
+    }
+#else
+    float v[4];
+    f32x4() {}
+    explicit f32x4(float s) { v[0] = v[1] = v[2] = v[3] = s; }
+    f32x4(float a, float b, float c, float d) { v[0] = a; v[1] = b; v[2] = c; v[3] = d; }
+
+    static f32x4 load(const float* p) { return f32x4(p[0], p[1], p[2], p[3]); }
+    static f32x4 loadu(const float* p) { return f32x4(p[0], p[1], p[2], p[3]); }
+    void store(float* p) const { for (int i = 0; i < 4; i++) p[i] = v[i]; }
+    void storeu(float* p) const { store(p); }
+
+    f32x4 operator+(f32x4 o) const { return f32x4(v[0] + o.v[0], v[1] + o.v[1], v[2] + o.v[2], v[3] + o.v[3]); }
+    f32x4 operator-(f32x4 o) const { return f32x4(v[0] - o.v[0], v[1] - o.v[1], v[2] - o.v[2], v[3] - o.v[3]); }
+    f32x4 operator*(f32x4 o) const { return f32x4(v[0] * o.v[0], v[1] * o.v[1], v[2] * o.v[2], v[3] * o.v[3]); }
+    f32x4 operator/(f32x4 o) const { return f32x4(v[0] / o.v[0], v[1] / o.v[1], v[2] / o.v[2], v[3] / o.v[3]); }
+    friend f32x4 min(f32x4 a, f32x4 b) {
+        return f32x4(fminf(a.v[0], b.v[0]), fminf(a.v[1], b.v[1]), fminf(a.v[2], b.v[2]), fminf(a.v[3], b.v[3]));
+    }
+    friend f32x4 max(f32x4 a, f32x4 b) {
+        return f32x4(fmaxf(a.v[0], b.v[0]), fmaxf(a.v[1], b.v[1]), fmaxf(a.v[2], b.v[2]), fmaxf(a.v[3], b.v[3]));
+    }
+    friend f32x4 sqrt(f32x4 a) { return f32x4(sqrtf(a.v[0]), sqrtf(a.v[1]), sqrtf(a.v[2]), sqrtf(a.v[3])); }
+    friend f32x4 rsqrt(f32x4 a) { return f32x4(1.0f) / sqrt(a); }
+    template <int L> f32x4 broadcast() const { return f32x4(v[L]); }
+    friend int signMask(f32x4 a) {
+        return (signbit(a.v[0]) ? 1 : 0) | (signbit(a.v[1]) ? 2 : 0) | (signbit(a.v[2]) ? 4 : 0) | (signbit(a.v[3]) ? 8 : 0);
+    }
+#endif
+    static const int LANES = 4;
+};
+
+// 8 làn float: một thanh ghi AVX, hoặc hai f32x4 khi không có AVX
+struct f32x8 {
+#if defined(MATH3D_AVX)
+    __m256 v;
+    f32x8() {}
+    f32x8(__m256 _v) : v(_v) {}
+    explicit f32x8(float s) : v(_mm256_set1_ps(s)) {}
+
+    static f32x8 load(const float* p) { return _mm256_load_ps(p); }   // p căn 32 byte
+    static f32x8 loadu(const float* p) { return _mm256_loadu_ps(p); }
+    void store(float* p) const { _mm256_store_ps(p, v); }
+    void storeu(float* p) const { _mm256_storeu_ps(p, v); }
+
+    f32x8 operator+(f32x8 o) const { return _mm256_add_ps(v, o.v); }
+    f32x8 operator-(f32x8 o) const { return _mm256_sub_ps(v, o.v); }
+    f32x8 operator*(f32x8 o) const { return _mm256_mul_ps(v, o.v); }
+    f32x8 operator/(f32x8 o) const { return _mm256_div_ps(v, o.v); }
+    friend f32x8 min(f32x8 a, f32x8 b) { return _mm256_min_ps(a.v, b.v); }
+    friend f32x8 max(f32x8 a, f32x8 b) { return _mm256_max_ps(a.v, b.v); }
+    friend f32x8 sqrt(f32x8 a) { return _mm256_sqrt_ps(a.v); }
+    friend f32x8 rsqrt(f32x8 a) {
+        __m256 y = _mm256_rsqrt_ps(a.v);
+        __m256 yy = _mm256_mul_ps(_mm256_mul_ps(a.v, y), y);
+        return _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(0.5f), y), _mm256_sub_ps(_mm256_set1_ps(3.0f), yy));
+    }
+    friend int signMask(f32x8 a) { return _mm256_movemask_ps(a.v); }
+#else
+    f32x4 lo, hi;
+    f32x8() {}
+    f32x8(f32x4 _lo, f32x4 _hi) : lo(_lo), hi(_hi) {}
+    explicit f32x8(float s) : lo(s), hi(s) {}
+
+    static f32x8 load(const float* p) { return f32x8(f32x4::load(p), f32x4::load(p + 4)); }
+    static f32x8 loadu(const float* p) { return f32x8(f32x4::loadu(p), f32x4::loadu(p + 4)); }
+    void store(float* p) const { lo.store(p); hi.store(p + 4); }
+    void storeu(float* p) const { lo.storeu(p); hi.storeu(p + 4); }
+
+    f32x8 operator+(f32x8 o) const { return f32x8(lo + o.lo, hi + o.hi); }
+    f32x8 operator-(f32x8 o) const { return f32x8(lo - o.lo, hi - o.hi); }
+    f32x8 operator*(f32x8 o) const { return f32x8(lo * o.lo, hi * o.hi); }
+    f32x8 operator/(f32x8 o) const { return f32x8(lo / o.lo, hi / o.hi); }
+    friend f32x8 min(f32x8 a, f32x8 b) { return f32x8(min(a.lo, b.lo), min(a.hi, b.hi)); }
+    friend f32x8 max(f32x8 a, f32x8 b) { return f32x8(max(a.lo, b.lo), max(a.hi, b.hi)); }
+    friend f32x8 sqrt(f32x8 a) { return f32x8(sqrt(a.lo), sqrt(a.hi)); }
+    friend f32x8 rsqrt(f32x8 a) { return f32x8(rsqrt(a.lo), rsqrt(a.hi)); }
+    friend int signMask(f32x8 a) { return signMask(a.lo) | (signMask(a.hi) << 4); }
+#endif
+    static const int LANES = 8;
+};
+
+// Chuyển vị 4 hàng r0..r3 (ma trận 4x4) tại chỗ
+inline void transpose4(f32x4& r0, f32x4& r1, f32x4& r2, f32x4& r3) {
+#if defined(MATH3D_SSE)
+    _MM_TRANSPOSE4_PS(r0.v, r1.v, r2.v, r3.v);
+#elif defined(MATH3D_NEON)
+    float32x4x2_t t01 = vtrnq_f32(r0.v, r1.v);
+    float32x4x2_t t23 = vtrnq_f32(r2.v, r3.v);
+    r0.v = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+    r1.v = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+    r2.v = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+    r3.v = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+#else
+    f32x4 a = r0, b = r1, c = r2, d = r3;
+    r0 = f32x4(a.v[0], b.v[0], c.v[0], d.v[0]);
+    r1 = f32x4(a.v[1], b.v[1], c.v[1], d.v[1]);
+    r2 = f32x4(a.v[2], b.v[2], c.v[2], d.v[2]);
+    r3 = f32x4(a.v[3], b.v[3], c.v[3], d.v[3]);
+#endif
+}
+
+#endif
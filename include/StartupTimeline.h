@@ -0,0 +1,70 @@
+#ifndef STARTUP_TIMELINE_H
+#define STARTUP_TIMELINE_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+using namespace std;
+
+// Ghi lại các pha khởi động (có thể từ nhiều luồng) và in ra dạng timeline để thấy phần chồng lấn
+class StartupTimeline {
+public:
+    struct Phase {
+        string name, lane; // lane: luồng chạy pha này ("main", "worker"...)
+        double startMs, endMs;
+    };
+
+    // Đo một pha theo phạm vi (RAII)
+    class Scope {
+    public:
+        Scope(StartupTimeline& timeline, const char* name, const char* lane)
+            : timeline(timeline), name(name), lane(lane), startMs(timeline.now()) {}
+        ~Scope() { timeline.record(name, lane, startMs, timeline.now()); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        StartupTimeline& timeline;
+        const char* name;
+        const char* lane;
+        double startMs;
+    };
+
+    StartupTimeline() : origin(chrono::steady_clock::now()) {}
+
+    // Mili giây kể từ lúc tạo timeline
+    double now() const { return chrono::duration<double, milli>(chrono::steady_clock::now() - origin).count(); }
+
+    void record(const string& name, const string& lane, double startMs, double endMs) {
+        lock_guard<mutex> lock(guard);
+        phases.push_back({ name, lane, startMs, endMs });
+    }
+
+    void print(FILE* out) {
+        lock_guard<mutex> lock(guard);
+        sort(phases.begin(), phases.end(), [](const Phase& a, const Phase& b) { return a.startMs < b.startMs; });
+        double total = 0.0;
+        for (const Phase& p : phases) total = max(total, p.endMs);
+
+        const int BAR = 40;
+        fprintf(out, "Startup timeline (%.1f ms)\n", total);
+        for (const Phase& p : phases) {
+            int from = total > 0.0 ? (int)(p.startMs / total * BAR) : 0;
+            int to = total > 0.0 ? (int)(p.endMs / total * BAR + 0.5) : 0;
+            to = max(to, from + 1);
+            string bar(BAR, ' ');
+            for (int i = from; i < to && i < BAR; ++i) bar[i] = '#';
+            fprintf(out, "  %-6s %7.1f %7.1f ms |%s| %s\n", p.lane.c_str(), p.startMs, p.endMs, bar.c_str(), p.name.c_str());
+        }
+    }
+
+private:
+    chrono::steady_clock::time_point origin;
+    mutex guard;
+    vector<Phase> phases;
+};
+
+#endif
@@ -0,0 +1,185 @@
+#ifndef STREAMING_ALLOCATOR_H
+#define STREAMING_ALLOCATOR_H
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+using namespace std;
+
+#include "GLExtensions.h"
+#include "GLStateCache.h"
+#include "Logger.h"
+
+// Cấp phát tuyến tính cho dữ liệu đỉnh sống một frame (minimap, HUD...): một VBO chia thành các vùng,
+// mỗi frame cấp phát trong một vùng, cuối frame đặt fence cho vùng đó. CPU không bao giờ chờ GPU:
+//  - Có buffer storage: buffer bất biến map PERSISTENT | COHERENT một lần, allocate() trả con trỏ ghi thẳng vào đó.
+//    Vòng bắt đầu với FRAMES vùng; vùng kế tiếp còn bận (GPU trễ hơn FRAMES - 1 frame) thì nới vòng thêm một vùng
+//    dự trữ (cấp sẵn, tối đa MAX_REGIONS); hết vùng dự trữ thì frame đó không cấp phát (allocate() trả NULL)
+//  - GL 3.3: allocate() trả con trỏ vào bản sao trên CPU, commit() chép phần mới bằng glMapBufferRange UNSYNCHRONIZED;
+//    vùng kế tiếp còn bận thì orphan cả buffer
+class StreamingAllocator {
+public:
+    static const int FRAMES = 3;
+    static const int MAX_REGIONS = FRAMES + 2; // Gồm vùng dự trữ của đường persistent
+
+    struct Allocation {
+        void* data = NULL;  // NULL nếu vùng của frame đã hết chỗ hoặc frame không có vùng
+        size_t offset = 0;  // Byte tính từ đầu buffer (dùng làm "first" khi chia cho stride)
+    };
+
+    struct Stats {
+        uint32_t grown = 0;      // Lần nới vòng thêm một vùng dự trữ (đường persistent)
+        uint32_t skipped = 0;    // Frame không có vùng trống nào, bỏ cấp phát (đường persistent)
+        uint32_t orphans = 0;    // Lần orphan buffer thay vì chờ (đường GL 3.3)
+        uint32_t failed = 0;     // Lần cấp phát thất bại vì vượt capacity
+        size_t peakBytes = 0;    // Nhiều nhất một frame đã dùng
+    };
+
+    // capacity: số byte mỗi frame; gọi sau khi có context và GLExtensions::load
+    void create(size_t capacityBytes) {
+        capacity = capacityBytes;
+        persistent = GLExtensions::bufferStorage;
+        glGenBuffers(1, &id);
+        glBindBuffer(GL_ARRAY_BUFFER, id);
+        if (persistent) {
+            GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            GLExtensions::bufferStorageAlloc(GL_ARRAY_BUFFER, capacity * MAX_REGIONS, NULL, flags);
+            mapped = (uint8_t*)glMapBufferRange(GL_ARRAY_BUFFER, 0, capacity * MAX_REGIONS, flags);
+            if (!mapped) {
+                // Không map được: bỏ buffer bất biến, quay về đường GL 3.3
+                LOG_ERROR("ERROR::STREAMING_ALLOCATOR::PERSISTENT_MAP_FAILED");
+                glDeleteBuffers(1, &id);
+                glGenBuffers(1, &id);
+                glBindBuffer(GL_ARRAY_BUFFER, id);
+                persistent = false;
+            }
+        }
+        if (!persistent) {
+            glBufferData(GL_ARRAY_BUFFER, capacity * FRAMES, NULL, GL_STREAM_DRAW);
+            staging.assign(capacity, 0);
+        }
+        ringSize = FRAMES;
+        region = ringSize - 1; // beginFrame đầu tiên chuyển sang vùng 0
+        usable = false;
+        head = committed = 0;
+    }
+
+    void destroy() {
+        for (GLsync& fence : fences) {
+            if (fence) glDeleteSync(fence);
+            fence = 0;
+        }
+        if (mapped) {
+            glBindBuffer(GL_ARRAY_BUFFER, id);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            mapped = NULL;
+        }
+        glDeleteBuffers(1, &id);
+        id = 0;
+        staging.clear();
+    }
+
+    unsigned int buffer() const { return id; }
+    bool isPersistent() const { return persistent; }
+
+    // Đầu frame: chuyển sang vùng kế tiếp mà GPU đã đọc xong - chỉ hỏi fence, không chờ
+    void beginFrame(GLStateCache& state) {
+        region = (region + 1) % ringSize;
+        usable = true;
+        if (!regionIdle(region)) {
+            if (persistent) {
+                if (ringSize < MAX_REGIONS) {
+                    // Vùng dự trữ chưa từng dùng (chưa có fence): thêm vào cuối vòng
+                    ++stats.grown;
+                    region = ringSize++;
+                } else {
+                    // Mọi vùng đều bận: frame này không cấp phát, không ghi đè vùng GPU còn đọc
+                    ++stats.skipped;
+                    usable = false;
+                }
+            } else {
+                // Orphan: driver cấp vùng nhớ mới, vùng cũ được giải phóng khi GPU dùng xong
+                ++stats.orphans;
+                state.bindArrayBuffer(id);
+                glBufferData(GL_ARRAY_BUFFER, capacity * FRAMES, NULL, GL_STREAM_DRAW);
+                for (GLsync& other : fences) {
+                    if (other) glDeleteSync(other);
+                    other = 0;
+                }
+            }
+        }
+        head = committed = regionStart();
+    }
+
+    // size byte, offset căn theo alignment (thường là stride của đỉnh - không cần là luỹ thừa của 2)
+    Allocation allocate(size_t size, size_t alignment) {
+        Allocation result;
+        if (!usable) return result;
+        size_t regionEnd = regionStart() + capacity;
+        size_t offset = (head + alignment - 1) / alignment * alignment;
+        if (offset + size > regionEnd) {
+            ++stats.failed;
+            return result;
+        }
+        head = offset + size;
+        stats.peakBytes = max(stats.peakBytes, head - regionStart());
+        result.offset = offset;
+        result.data = persistent ? mapped + offset : &staging[offset - regionStart()];
+        return result;
+    }
+
+    // Gọi trước lệnh vẽ dùng các Allocation vừa ghi (persistent + coherent: không cần làm gì)
+    void commit(GLStateCache& state) {
+        if (persistent || committed == head) return;
+        state.bindArrayBuffer(id);
+        void* dst = glMapBufferRange(GL_ARRAY_BUFFER, committed, head - committed,
+                                     GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+        if (dst) {
+            memcpy(dst, &staging[committed - regionStart()], head - committed);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+        }
+        committed = head;
+    }
+
+    // Gọi sau lệnh vẽ cuối cùng của frame
+    void endFrame() {
+        if (!usable) return;
+        if (fences[region]) glDeleteSync(fences[region]);
+        fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    const Stats& getStats() const { return stats; }
+
+private:
+    unsigned int id = 0;
+    size_t capacity = 0;
+    bool persistent = false;
+    uint8_t* mapped = NULL;
+    vector<uint8_t> staging; // Bản sao vùng hiện tại, chỉ dùng ở đường GL 3.3
+    int ringSize = FRAMES;          // Số vùng đang xoay vòng (chỉ tăng trên đường persistent)
+    int region = 0;                 // Vùng của frame hiện tại
+    bool usable = false;            // false: frame hiện tại không có vùng trống
+    size_t head = 0, committed = 0; // Byte đã cấp / đã chép lên GPU trong vùng hiện tại
+    GLsync fences[MAX_REGIONS] = {};
+    Stats stats;
+
+    size_t regionStart() const { return (size_t)region * capacity; }
+
+    // true nếu GPU đã đọc xong vùng (xoá fence); fence lỗi (GL_WAIT_FAILED) coi như vẫn bận
+    bool regionIdle(int index) {
+        GLsync fence = fences[index];
+        if (!fence) return true;
+        GLenum status = glClientWaitSync(fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            if (status == GL_WAIT_FAILED) LOG_ERROR("ERROR::STREAMING_ALLOCATOR::FENCE_WAIT_FAILED");
+            return false;
+        }
+        glDeleteSync(fence);
+        fences[index] = 0;
+        return true;
+    }
+};
+
+#endif
@@ -1,22 +1,110 @@
 #ifndef TERRAIN_H
 #define TERRAIN_H
 
+#include <cstdint>
 #include <vector>
 using namespace std;
 
 #include "Math3D.h"
+#include "Parallel.h"
 
 class Terrain {
 public:
     int width, height;
     vector<float> vertices; // Lưu x, y, z, nx, ny, nz (6 float/vertex)
     vector<unsigned int> indices;
+    vector<float> ambientOcclusion; // AO mỗi đỉnh: 1 = thấy toàn bộ bầu trời, 0 = bị che hoàn toàn
 
-    Terrain(int w, int h) : width(w), height(h) {
-        generateTerrain();
+    // Tham số bake AO mặc định (được lưu kèm cache để phát hiện cache cũ)
+    static const int AO_DIRECTIONS = 16;
+    static const int AO_MAX_STEPS = 24;
+
+    // Tham số sinh địa hình (generateTerrain) - cũng được băm vào key của cache
+    static constexpr float HILL_HEIGHT = 16.0f;
+    static constexpr float HILL_RADIUS = 0.65f;  // Tỉ lệ so với khoảng cách tâm -> góc
+    static constexpr float NOISE_FREQUENCY[3] = { 0.25f, 0.5f, 1.0f };
+    static constexpr float NOISE_AMPLITUDE[3] = { 1.8f, 0.9f, 0.4f };
+    static constexpr float NOISE_RADIUS = 0.75f; // Noise chỉ thêm trong vùng normalizedDist < NOISE_RADIUS
+    static constexpr float MIN_HEIGHT = 0.8f;    // Không có đỉnh nào chìm dưới mặt nước
+
+    // FNV-1a trên mọi tham số sinh địa hình + bake AO: đổi một hằng số ở trên là cache cũ tự bị loại.
+    // Đổi thuật toán (code trong generateTerrain/bakeAmbientOcclusion) thì vẫn phải tăng TerrainCache::VERSION
+    static uint32_t parameterHash() {
+        const float floats[] = { HILL_HEIGHT, HILL_RADIUS,
+                                 NOISE_FREQUENCY[0], NOISE_FREQUENCY[1], NOISE_FREQUENCY[2],
+                                 NOISE_AMPLITUDE[0], NOISE_AMPLITUDE[1], NOISE_AMPLITUDE[2],
+                                 NOISE_RADIUS, MIN_HEIGHT };
+        const int ints[] = { AO_DIRECTIONS, AO_MAX_STEPS };
+        uint32_t hash = 2166136261u;
+        auto mix = [&](const void* data, size_t size) {
+            const unsigned char* bytes = (const unsigned char*)data;
+            for (size_t i = 0; i < size; ++i) hash = (hash ^ bytes[i]) * 16777619u;
+        };
+        mix(floats, sizeof(floats));
+        mix(ints, sizeof(ints));
+        return hash;
+    }
+
+    Terrain(int w, int h, bool generate = true) : width(w), height(h) {
+        if (generate) generateTerrain();
+    }
+
+    // Độ cao tại đỉnh lưới (x, z)
+    float heightAt(int x, int z) const { return vertices[(z * width + x) * 6 + 1]; }
+
+    // Độ cao nội suy song tuyến tại toạ độ lưới thực (fx, fz) nằm trong lưới
+    float sampleHeight(float fx, float fz) const {
+        int x0 = min((int)fx, width - 2);
+        int z0 = min((int)fz, height - 2);
+        float tx = fx - x0;
+        float tz = fz - z0;
+        float h00 = heightAt(x0, z0), h10 = heightAt(x0 + 1, z0);
+        float h01 = heightAt(x0, z0 + 1), h11 = heightAt(x0 + 1, z0 + 1);
+        float a = h00 + (h10 - h00) * tx;
+        float b = h01 + (h11 - h01) * tx;
+        return a + (b - a) * tz;
+    }
+
+    // Bake Ambient Occlusion tĩnh (sky visibility) bằng horizon scan trên heightmap
+    // Mỗi đỉnh quét numDirections hướng, tìm góc chân trời lớn nhất theo từng hướng;
+    // phần bầu trời nhìn thấy theo hướng đó = cos^2(góc chân trời) (trọng số cosine)
+    void bakeAmbientOcclusion(int numDirections = AO_DIRECTIONS, int maxSteps = AO_MAX_STEPS) {
+        ambientOcclusion.assign((size_t)width * height, 1.0f);
+
+        vector<float> dirX(numDirections), dirZ(numDirections);
+        for (int d = 0; d < numDirections; ++d) {
+            float angle = d * 2.0f * PI / numDirections;
+            dirX[d] = cos(angle);
+            dirZ[d] = sin(angle);
+        }
+
+        // Mỗi luồng xử lý một dải hàng z liên tiếp
+        parallelFor(0, height, [&](int zBegin, int zEnd) {
+            for (int z = zBegin; z < zEnd; ++z) {
+                for (int x = 0; x < width; ++x) {
+                    float h0 = heightAt(x, z);
+                    float visibility = 0.0f;
+                    for (int d = 0; d < numDirections; ++d) {
+                        float maxSlope = 0.0f; // tan(góc chân trời), chỉ tính phần nhô lên
+                        for (int s = 1; s <= maxSteps; ++s) {
+                            float px = x + dirX[d] * s;
+                            float pz = z + dirZ[d] * s;
+                            // Ra ngoài lưới là biển phẳng - không che
+                            if (px < 0.0f || pz < 0.0f || px > width - 1 || pz > height - 1) break;
+                            float slope = (sampleHeight(px, pz) - h0) / (float)s;
+                            if (slope > maxSlope) maxSlope = slope;
+                        }
+                        // cos^2(atan(t)) = 1 / (1 + t^2)
+                        visibility += 1.0f / (1.0f + maxSlope * maxSlope);
+                    }
+                    ambientOcclusion[z * width + x] = visibility / numDirections;
+                }
+            }
+        });
     }
 
     //  Tạo lưới đa giác (Polygon Mesh) - Đồi núi tròn, đỉnh mượt, đặt giữa biển
+    // Kết quả được cache (TerrainCache): sửa thuật toán ở đây thì tăng TerrainCache::VERSION
     void generateTerrain() {
         // 1. Tạo đỉnh và độ cao - HeightMap
         vector<Vec3> tempVertices;
@@ -39,8 +127,8 @@ public:
                 
                 // Tạo đồi núi với đỉnh bo tròn mượt (không nhọn)
                 float y = 0.0f;
-                float hillHeight = 16.0f;
-                float hillRadius = maxRadius * 0.65f; // Bán kính đồi
+                float hillHeight = HILL_HEIGHT;
+                float hillRadius = maxRadius * HILL_RADIUS; // Bán kính đồi
                 
                 if (dist < hillRadius) {
                     // Dùng smoothstep để tạo đỉnh tròn mượt, không nhọn
@@ -51,75 +139,123 @@ public:
                 }
                 
                 // Thêm các đỉnh núi phụ với đỉnh tròn
-                float noise1 = sin(fx * 0.25f) * cos(fz * 0.25f) * 1.8f;
-                float noise2 = sin(fx * 0.5f) * cos(fz * 0.5f) * 0.9f;
-                float noise3 = sin(fx * 1.0f) * cos(fz * 1.0f) * 0.4f;
+                float noise1 = sin(fx * NOISE_FREQUENCY[0]) * cos(fz * NOISE_FREQUENCY[0]) * NOISE_AMPLITUDE[0];
+                float noise2 = sin(fx * NOISE_FREQUENCY[1]) * cos(fz * NOISE_FREQUENCY[1]) * NOISE_AMPLITUDE[1];
+                float noise3 = sin(fx * NOISE_FREQUENCY[2]) * cos(fz * NOISE_FREQUENCY[2]) * NOISE_AMPLITUDE[2];
                 
                 // Chỉ thêm noise ở vùng đồi (không thêm ở biên)
-                if (normalizedDist < 0.75f) {
-                    float noiseFactor = 1.0f - (normalizedDist / 0.75f);
+                if (normalizedDist < NOISE_RADIUS) {
+                    float noiseFactor = 1.0f - (normalizedDist / NOISE_RADIUS);
                     // Smoothstep cho noise để đỉnh phụ cũng tròn
                     noiseFactor = noiseFactor * noiseFactor * (3.0f - 2.0f * noiseFactor);
                     y += (noise1 + noise2 + noise3) * noiseFactor;
                 }
                 
                 // Đảm bảo không có vùng âm (nổi trên mặt nước)
-                y = max(y, 0.8f);
+                y = max(y, MIN_HEIGHT);
                 
                 tempVertices.push_back(Vec3(fx, y, fz));
             }
         }
 
         // 2. Tính pháp tuyến (Normals) cho Tô bóng Gouraud [CG.6 - Slide 29]
-        // Mảng chứa tổng pháp tuyến cho mỗi đỉnh
-        vector<Vec3> tempNormals(tempVertices.size(), Vec3(0, 0, 0));
+        // Pháp tuyến mặt của 2 tam giác mỗi ô lưu dạng SoA trên lưới có viền 0 (thêm một hàng/cột ô ở mỗi phía),
+        // ô (x, z) nằm ở (z + 1) * stride + (x + 1): đỉnh nào cũng đọc đủ 4 ô kề mà không cần rẽ nhánh ở biên
+        const int stride = width + 1;
+        const size_t faceCount = (size_t)stride * (height + 1);
+        vector<float> n1x(faceCount, 0.0f), n1y(faceCount, 0.0f), n1z(faceCount, 0.0f); // Tam giác 1: i0, i2, i1
+        vector<float> n2x(faceCount, 0.0f), n2y(faceCount, 0.0f), n2z(faceCount, 0.0f); // Tam giác 2: i1, i2, i3
+
+        // Kernel đọc tempVertices như mảng float liền nhau bước 3
+        static_assert(sizeof(Vec3) == 3 * sizeof(float), "Vec3 must be tightly packed for loadInterleaved(..., 3)");
 
         // Duyệt qua từng ô lưới (mỗi ô là 2 tam giác)
         for (int z = 0; z < height - 1; ++z) {
-            for (int x = 0; x < width - 1; ++x) {
-                // 4 đỉnh của ô
+            size_t face = (size_t)(z + 1) * stride + 1;
+            int x = 0;
+            // 4 ô liền nhau mỗi lần: pháp tuyến mặt tính bằng Vec3x4 (SoA), ghi thẳng ra mảng SoA
+            for (; x + Vec3x4::LANES <= width - 1; x += Vec3x4::LANES) {
+                const float* row0 = &tempVertices[z * width + x].x;
+                const float* row1 = &tempVertices[(z + 1) * width + x].x;
+                Vec3x4 p0 = Vec3x4::loadInterleaved(row0, 3);     // i0
+                Vec3x4 p1 = Vec3x4::loadInterleaved(row0 + 3, 3); // i1
+                Vec3x4 p2 = Vec3x4::loadInterleaved(row1, 3);     // i2
+                Vec3x4 p3 = Vec3x4::loadInterleaved(row1 + 3, 3); // i3
+
+                // [CG.6 - Slide 8] Tích có hướng
+                (p2 - p0).cross(p1 - p0).normalize().storeu(&n1x[face + x], &n1y[face + x], &n1z[face + x]);
+                (p2 - p1).cross(p3 - p1).normalize().storeu(&n2x[face + x], &n2y[face + x], &n2z[face + x]);
+            }
+            // Phần dư cuối hàng
+            for (; x < width - 1; ++x) {
                 int i0 = z * width + x;
                 int i1 = z * width + (x + 1);
                 int i2 = (z + 1) * width + x;
                 int i3 = (z + 1) * width + (x + 1);
+                Vec3 normal1 = normalizeLane((tempVertices[i2] - tempVertices[i0]).cross(tempVertices[i1] - tempVertices[i0]));
+                Vec3 normal2 = normalizeLane((tempVertices[i2] - tempVertices[i1]).cross(tempVertices[i3] - tempVertices[i1]));
+                n1x[face + x] = normal1.x; n1y[face + x] = normal1.y; n1z[face + x] = normal1.z;
+                n2x[face + x] = normal2.x; n2y[face + x] = normal2.y; n2z[face + x] = normal2.z;
+            }
+        }
 
-                // Tam giác 1: i0, i2, i1
-                Vec3 v1 = tempVertices[i2] - tempVertices[i0];
-                Vec3 v2 = tempVertices[i1] - tempVertices[i0];
-                Vec3 normal1 = v1.cross(v2).normalize(); // [CG.6 - Slide 8] Tích có hướng
-
-                // Cộng dồn pháp tuyến vào các đỉnh tham gia (Gouraud Average)
-                tempNormals[i0] = tempNormals[i0] + normal1;
-                tempNormals[i2] = tempNormals[i2] + normal1;
-                tempNormals[i1] = tempNormals[i1] + normal1;
-
-                // Tam giác 2: i1, i2, i3
-                Vec3 v3 = tempVertices[i2] - tempVertices[i1];
-                Vec3 v4 = tempVertices[i3] - tempVertices[i1];
-                Vec3 normal2 = v3.cross(v4).normalize();
-
-                tempNormals[i1] = tempNormals[i1] + normal2;
-                tempNormals[i2] = tempNormals[i2] + normal2;
-                tempNormals[i3] = tempNormals[i3] + normal2;
-
-                // Lưu indices cho EBO
+        // Lưu indices cho EBO
+        indices.reserve((size_t)(width - 1) * (height - 1) * 6);
+        for (int z = 0; z < height - 1; ++z) {
+            for (int x = 0; x < width - 1; ++x) {
+                int i0 = z * width + x;
+                int i1 = z * width + (x + 1);
+                int i2 = (z + 1) * width + x;
+                int i3 = (z + 1) * width + (x + 1);
                 indices.push_back(i0); indices.push_back(i2); indices.push_back(i1);
                 indices.push_back(i1); indices.push_back(i2); indices.push_back(i3);
             }
         }
 
-        // 3. Đóng gói dữ liệu (Vị trí + Pháp tuyến đã chuẩn hóa)
-        for (size_t i = 0; i < tempVertices.size(); ++i) {
-            vertices.push_back(tempVertices[i].x);
-            vertices.push_back(tempVertices[i].y);
-            vertices.push_back(tempVertices[i].z);
-            
-            Vec3 n = tempNormals[i].normalize();
-            vertices.push_back(n.x);
-            vertices.push_back(n.y);
-            vertices.push_back(n.z);
+        // 3. Đóng gói dữ liệu (Vị trí + Pháp tuyến). Pháp tuyến đỉnh = tổng pháp tuyến các tam giác chứa nó
+        // (Gouraud Average): ô (x, z) góp tam giác 1, ô (x-1, z) và (x, z-1) góp cả hai, ô (x-1, z-1) góp tam giác 2.
+        // Cộng và chuẩn hoá 4 đỉnh mỗi lần trong SoA, chỉ chuyển sang layout xen kẽ 6 float ở lần ghi cuối
+        size_t count = tempVertices.size();
+        vertices.resize(count * 6);
+        for (size_t i = 0; i < count; ++i) {
+            vertices[i * 6 + 0] = tempVertices[i].x;
+            vertices[i * 6 + 1] = tempVertices[i].y;
+            vertices[i * 6 + 2] = tempVertices[i].z;
+        }
+        auto vertexNormal = [&](size_t cell) { // cell: chỉ số của ô (x, z) trên lưới có viền
+            size_t left = cell - 1, below = cell - stride, corner = cell - stride - 1;
+            return Vec3(((n1x[cell] + (n1x[left] + n2x[left])) + (n1x[below] + n2x[below])) + n2x[corner],
+                        ((n1y[cell] + (n1y[left] + n2y[left])) + (n1y[below] + n2y[below])) + n2y[corner],
+                        ((n1z[cell] + (n1z[left] + n2z[left])) + (n1z[below] + n2z[below])) + n2z[corner]);
+        };
+        for (int z = 0; z < height; ++z) {
+            size_t face = (size_t)(z + 1) * stride + 1;
+            float* row = &vertices[(size_t)z * width * 6 + 3];
+            int x = 0;
+            for (; x + Vec3x4::LANES <= width; x += Vec3x4::LANES) {
+                size_t cell = face + x, left = cell - 1, below = cell - stride, corner = cell - stride - 1;
+                Vec3x4 sum = Vec3x4::loadu(&n1x[cell], &n1y[cell], &n1z[cell])
+                           + (Vec3x4::loadu(&n1x[left], &n1y[left], &n1z[left])
+                              + Vec3x4::loadu(&n2x[left], &n2y[left], &n2z[left]));
+                sum = sum + (Vec3x4::loadu(&n1x[below], &n1y[below], &n1z[below])
+                             + Vec3x4::loadu(&n2x[below], &n2y[below], &n2z[below]));
+                sum = sum + Vec3x4::loadu(&n2x[corner], &n2y[corner], &n2z[corner]);
+                sum.normalize().storeInterleaved(row + x * 6);
+            }
+            // Phần dư cuối hàng: cùng thứ tự cộng và cùng phép chuẩn hoá với thân SIMD
+            for (; x < width; ++x) {
+                Vec3 n = normalizeLane(vertexNormal(face + x));
+                row[x * 6 + 0] = n.x;
+                row[x * 6 + 1] = n.y;
+                row[x * 6 + 2] = n.z;
+            }
         }
     }
+
+private:
+    // Chuẩn hoá một vector bằng đúng phép tính của Vec3x4::normalize (rsqrt + Newton) để phần dư
+    // cuối hàng cho cùng kết quả với thân SIMD - pháp tuyến không phụ thuộc vị trí trong hàng
+    static Vec3 normalizeLane(const Vec3& v) { return Vec3x4(v).normalize().lane(0); }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,97 @@
+#ifndef TERRAIN_CACHE_H
+#define TERRAIN_CACHE_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+using namespace std;
+
+#include "Terrain.h"
+#include "Logger.h"
+
+// Cache nhị phân cho lưới địa hình + AO đã bake, tránh bake lại mỗi lần khởi động
+// Định dạng: header cố định, sau đó là vertices, indices, ambientOcclusion
+class TerrainCache {
+public:
+    // Tăng khi thay đổi thuật toán sinh địa hình/bake hoặc định dạng file
+    // (đổi tham số thì không cần: Terrain::parameterHash() nằm trong header)
+    static const uint32_t VERSION = 5;
+
+    static bool load(const string& path, Terrain& terrain) {
+        ifstream file(path, ios::binary);
+        if (!file.is_open()) return false;
+
+        Header header;
+        if (!file.read((char*)&header, sizeof(header))) return false;
+        if (header.magic != MAGIC || header.version != VERSION ||
+            header.width != (uint32_t)terrain.width || header.height != (uint32_t)terrain.height ||
+            header.aoDirections != (uint32_t)Terrain::AO_DIRECTIONS ||
+            header.aoMaxSteps != (uint32_t)Terrain::AO_MAX_STEPS ||
+            header.parameterHash != Terrain::parameterHash()) {
+            LOG_WARN("Terrain cache is stale, rebuilding: " << path);
+            return false;
+        }
+        // Kích thước mảng suy ra được từ width/height - không tin số trong file trước khi cấp phát
+        uint64_t cells = (uint64_t)terrain.width * terrain.height;
+        uint64_t quads = (uint64_t)(terrain.width - 1) * (terrain.height - 1);
+        if (cells == 0 || header.vertexFloats != cells * 6 || header.indexCount != quads * 6 || header.aoCount != cells) {
+            LOG_WARN("Terrain cache is corrupt, rebuilding: " << path);
+            return false;
+        }
+
+        vector<float> vertices(header.vertexFloats);
+        vector<unsigned int> indices(header.indexCount);
+        vector<float> ao(header.aoCount);
+        if (!file.read((char*)vertices.data(), vertices.size() * sizeof(float)) ||
+            !file.read((char*)indices.data(), indices.size() * sizeof(unsigned int)) ||
+            !file.read((char*)ao.data(), ao.size() * sizeof(float))) {
+            LOG_WARN("Terrain cache is truncated, rebuilding: " << path);
+            return false;
+        }
+
+        terrain.vertices.swap(vertices);
+        terrain.indices.swap(indices);
+        terrain.ambientOcclusion.swap(ao);
+        return true;
+    }
+
+    static bool save(const string& path, const Terrain& terrain) {
+        ofstream file(path, ios::binary | ios::trunc);
+        if (!file.is_open()) {
+            LOG_ERROR("ERROR::TERRAIN_CACHE::CANNOT_WRITE: " << path);
+            return false;
+        }
+
+        Header header;
+        header.magic = MAGIC;
+        header.version = VERSION;
+        header.width = terrain.width;
+        header.height = terrain.height;
+        header.aoDirections = Terrain::AO_DIRECTIONS;
+        header.aoMaxSteps = Terrain::AO_MAX_STEPS;
+        header.parameterHash = Terrain::parameterHash();
+        header.vertexFloats = (uint32_t)terrain.vertices.size();
+        header.indexCount = (uint32_t)terrain.indices.size();
+        header.aoCount = (uint32_t)terrain.ambientOcclusion.size();
+
+        file.write((const char*)&header, sizeof(header));
+        file.write((const char*)terrain.vertices.data(), terrain.vertices.size() * sizeof(float));
+        file.write((const char*)terrain.indices.data(), terrain.indices.size() * sizeof(unsigned int));
+        file.write((const char*)terrain.ambientOcclusion.data(), terrain.ambientOcclusion.size() * sizeof(float));
+        return (bool)file;
+    }
+
+private:
+    static const uint32_t MAGIC = 0x434E5254; // "TRNC"
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t width, height;
+        uint32_t aoDirections, aoMaxSteps;
+        uint32_t parameterHash;
+        uint32_t vertexFloats, indexCount, aoCount;
+    };
+};
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef UNIFORM_CACHE_H
+#define UNIFORM_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+using namespace std;
+
+// Tên uniform kèm hash FNV-1a 32 bit. Với chuỗi literal ("model") hash được tính lúc biên dịch,
+// nên tra cứu trên hot path không tạo std::string. Chỉ giữ con trỏ: chuỗi phải sống hết lần gọi
+struct UniformName {
+    const char* str;
+    uint32_t hash;
+
+    template <size_t N>
+    constexpr UniformName(const char (&s)[N]) : str(s), hash(fnv1a(s, N - 1)) {}
+    constexpr UniformName(const char* s, size_t length) : str(s), hash(fnv1a(s, length)) {}
+
+    static constexpr uint32_t fnv1a(const char* s, size_t n) {
+        uint32_t h = 2166136261u;
+        for (size_t i = 0; i < n; ++i) h = (h ^ (uint8_t)s[i]) * 16777619u;
+        return h;
+    }
+};
+
+static_assert(UniformName("model").hash == UniformName::fnv1a("model", 5), "uniform name hashes at compile time");
+
+// Bảng băm phẳng (open addressing, dò tuyến tính) tên -> uniform location
+// Lưu cả location -1 (uniform không tồn tại/bị tối ưu mất) để không hỏi driver lại
+// Mỗi ô giữ bản sao tên: trùng hash chỉ là gợi ý, tên khác nhau (va chạm) vẫn là hai ô riêng
+class UniformCache {
+public:
+    static const int CAPACITY = 64; // Luỹ thừa của 2, dư sức cho một program
+
+    UniformCache() { clear(); }
+
+    void clear() {
+        for (Slot& s : slots) {
+            s.used = false;
+            s.name.clear();
+        }
+        count = 0;
+    }
+
+    bool find(const UniformName& name, int& location) const {
+        for (uint32_t i = name.hash & MASK, probes = 0; probes < (uint32_t)CAPACITY; i = (i + 1) & MASK, ++probes) {
+            if (!slots[i].used) return false;
+            if (slots[i].matches(name)) {
+                location = slots[i].location;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Trả về false nếu bảng đầy (khi đó người gọi cứ hỏi driver như cũ)
+    bool insert(const UniformName& name, int location) {
+        for (uint32_t i = name.hash & MASK, probes = 0; probes < (uint32_t)CAPACITY; i = (i + 1) & MASK, ++probes) {
+            if (!slots[i].used || slots[i].matches(name)) {
+                if (!slots[i].used) ++count;
+                slots[i].used = true;
+                slots[i].hash = name.hash;
+                slots[i].name = name.str;
+                slots[i].location = location;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    int size() const { return count; }
+
+private:
+    static const uint32_t MASK = CAPACITY - 1;
+
+    struct Slot {
+        uint32_t hash;
+        int location;
+        bool used;
+        string name;
+
+        // So hash trước, chuỗi chỉ khi hash trùng
+        bool matches(const UniformName& other) const { return hash == other.hash && strcmp(name.c_str(), other.str) == 0; }
+    };
+    Slot slots[CAPACITY];
+    int count;
+};
+
+#endif
@@ -1,32 +1,114 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <vector>
-#include <iostream>
 #include <cmath>
+#include <chrono>
+#include <array>
+#include <thread>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
 using namespace std;
 
 #include "Math3D.h"
 #include "Camera.h"
 #include "Terrain.h"
+#include "TerrainCache.h"
+#include "HorizonMap.h"
+#include "Frustum.h"
 #include "Shader.h"
+#include "ShaderHotReload.h"
+#include "GLExtensions.h"
+#include "GLStateCache.h"
+#include "GpuTimer.h"
+#include "Hud.h"
+#include "MinimapTrail.h"
+#include "StreamingAllocator.h"
+#include "FrameUniforms.h"
+#include "StartupTimeline.h"
+#include "HeadlessContext.h"
+#include "Flythrough.h"
+#include "Profiler.h"
+#include "InputRecording.h"
+#include "Logger.h"
 #include "Algorithms2D.h"
 
 // Cài đặt màn hình
 const unsigned int SCR_WIDTH = 1280;
 const unsigned int SCR_HEIGHT = 720;
 
+// Các phép biến đổi cố định - tính hoàn toàn lúc biên dịch (constexpr Math3D)
+// Terrain và nước đặt giữa gốc toạ độ, nổi trên mặt nước y = 0
+constexpr Mat4 TERRAIN_MODEL = Mat4::translate(Vec3(-25.0f, 0.0f, -25.0f));
+constexpr Mat4 WATER_MODEL = Mat4::translate(Vec3(-25.0f, 0.0f, -25.0f));
+// Normal matrix (nghịch đảo chuyển vị phần 3x3 của model) - đúng cả khi model scale không đều
+constexpr Mat3 TERRAIN_NORMAL_MATRIX = TERRAIN_MODEL.normalMatrix();
+constexpr Mat4 PROJECTION = Mat4::perspective(45.0f * PI / 180.0f, (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 200.0f);
+constexpr Mat4 UI_ORTHO = Mat4::ortho(0.0f, (float)SCR_WIDTH, 0.0f, (float)SCR_HEIGHT, -1.0f, 1.0f);
+
+// Bảng điểm hình tròn marker camera trên minimap (8 điểm, bán kính 3 pixel)
+constexpr array<Vec3, 8> makeMarkerCircle() {
+    array<Vec3, 8> points{};
+    for (int i = 0; i < 8; ++i) {
+        float angle = i * 2.0f * PI / 8.0f;
+        points[i] = Vec3(math3d::cos(angle) * 3.0f, math3d::sin(angle) * 3.0f, 0.0f);
+    }
+    return points;
+}
+constexpr array<Vec3, 8> MARKER_CIRCLE = makeMarkerCircle();
+
+// Minimap: góc dưới bên phải, khung 4 cạnh (GL_LINES) không đổi nên upload một lần vào buffer tĩnh
+const int MINIMAP_SIZE = 200;
+constexpr float MINIMAP_X = SCR_WIDTH - MINIMAP_SIZE - 20.0f;
+constexpr float MINIMAP_Y = 20.0f;
+constexpr array<Vec3, 8> MINIMAP_FRAME = {
+    Vec3(MINIMAP_X, MINIMAP_Y, 0.0f), Vec3(MINIMAP_X + MINIMAP_SIZE, MINIMAP_Y, 0.0f),
+    Vec3(MINIMAP_X + MINIMAP_SIZE, MINIMAP_Y, 0.0f), Vec3(MINIMAP_X + MINIMAP_SIZE, MINIMAP_Y + MINIMAP_SIZE, 0.0f),
+    Vec3(MINIMAP_X + MINIMAP_SIZE, MINIMAP_Y + MINIMAP_SIZE, 0.0f), Vec3(MINIMAP_X, MINIMAP_Y + MINIMAP_SIZE, 0.0f),
+    Vec3(MINIMAP_X, MINIMAP_Y + MINIMAP_SIZE, 0.0f), Vec3(MINIMAP_X, MINIMAP_Y, 0.0f)
+};
+
+static_assert(TERRAIN_MODEL.m[3][0] == -25.0f && TERRAIN_MODEL.m[3][2] == -25.0f && TERRAIN_MODEL.m[0][0] == 1.0f,
+              "terrain model folds at compile time");
+static_assert(TERRAIN_NORMAL_MATRIX.m[0][0] == 1.0f && TERRAIN_NORMAL_MATRIX.m[2][1] == 0.0f,
+              "normal matrix folds at compile time");
+static_assert(PROJECTION.m[2][3] == -1.0f && PROJECTION.m[1][1] > 2.4142f && PROJECTION.m[1][1] < 2.4143f,
+              "projection folds at compile time (1/tan(22.5 deg))");
+static_assert(UI_ORTHO.m[3][0] == -1.0f && UI_ORTHO.m[0][0] == 2.0f / SCR_WIDTH, "ortho folds at compile time");
+static_assert(MARKER_CIRCLE[0].x == 3.0f && MARKER_CIRCLE[2].y > 2.99999f && MARKER_CIRCLE[4].x < -2.99999f,
+              "marker table folds at compile time");
+
 // Camera - Đặt ở vị trí tốt để nhìn đồi núi giữa biển
 Camera camera(Vec3(15.0f, 8.0f, 35.0f));
 float lastX = SCR_WIDTH / 2.0f;
 float lastY = SCR_HEIGHT / 2.0f;
 bool firstMouse = true;
+float mouseOffsetX = 0.0f, mouseOffsetY = 0.0f; // Cộng dồn từ mouse_callback đến lần pollInput kế tiếp
 float deltaTime = 0.0f;
 float lastFrame = 0.0f;
 
+// Mọi thay đổi trạng thái GL trong vòng lặp render đi qua đây (bỏ lệnh trùng)
+GLStateCache glState;
+
+// Thời gian GPU từng pass (đọc trễ vài frame, không chặn)
+enum GpuPass { GPU_PASS_WATER, GPU_PASS_TERRAIN, GPU_PASS_UI };
+GpuPassTimer gpuTimer;
+
+// Mọi dữ liệu đỉnh đổi mỗi frame (minimap, HUD...) cấp phát từ đây - 3 vùng + fence, không glBufferData mỗi frame
+StreamingAllocator streamAllocator;
+const size_t STREAM_BYTES_PER_FRAME = 256 * 1024;
+
+// HUD hiệu năng (H để ẩn/hiện)
+Hud hud;
+bool showHud = true;
+
+// Cache địa hình + AO đã bake (đường dẫn tương đối: nằm trong thư mục làm việc hiện tại)
+const char* TERRAIN_CACHE_PATH = "terrain_cache.bin";
+
 // Minimap settings
-const int MINIMAP_SIZE = 200;
-vector<Vec3> pathTrace; // Lưu đường đi cho Bresenham
+MinimapTrail minimapTrail; // Đường đi (Bresenham) dạng bitmap 200x200 - bộ nhớ không tăng theo thời gian chạy
 
 // Lighting settings
 Vec3 lightPos(0.0f, 20.0f, 0.0f); // Point Light position (di chuyển được)
@@ -40,59 +122,96 @@ enum DisplayMode {
 };
 DisplayMode displayMode = DISPLAY_SMOOTH; // Mặc định là Smooth
 
-// Callback xử lý chuột
+// Mỗi tổ hợp (displayMode, shadingModel) là một key biến thể của terrain shader
+const int SHADING_MODEL_COUNT = 2;
+int terrainVariantKey(int display, int shading) { return display * SHADING_MODEL_COUNT + shading; }
+
+// Bộ #define cho từng key: Flat bỏ qua shadingModel, Wireframe dùng chung shader với Smooth
+vector<string> terrainVariantDefines() {
+    vector<string> defines(3 * SHADING_MODEL_COUNT);
+    for (int display = 0; display < 3; ++display) {
+        for (int shading = 0; shading < SHADING_MODEL_COUNT; ++shading) {
+            string lighting = display == DISPLAY_FLAT ? "LIGHTING_FLAT"
+                            : shading == 0 ? "LIGHTING_GOURAUD" : "LIGHTING_PHONG";
+            defines[terrainVariantKey(display, shading)] = "#define " + lighting + "\n";
+        }
+    }
+    return defines;
+}
+
+// Callback xử lý chuột: chỉ cộng dồn offset, camera quay trong processInput (để ghi/phát lại được)
 void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
     if (firstMouse) { lastX = xpos; lastY = ypos; firstMouse = false; }
-    float xoffset = xpos - lastX;
-    float yoffset = lastY - ypos; // Đảo ngược y
+    mouseOffsetX += xpos - lastX;
+    mouseOffsetY += lastY - ypos; // Đảo ngược y
     lastX = xpos; lastY = ypos;
-    camera.processMouseMovement(xoffset, yoffset);
 }
 
-// Xử lý bàn phím
-void processInput(GLFWwindow* window) {
+// Đọc trạng thái phím + chuột của frame từ GLFW (lấy luôn phần offset chuột đã cộng dồn)
+InputFrame pollInput(GLFWwindow* window, float frameDelta) {
+    static const int GLFW_KEYS[INPUT_KEY_COUNT] = {
+        GLFW_KEY_ESCAPE, GLFW_KEY_W, GLFW_KEY_S, GLFW_KEY_A, GLFW_KEY_D,
+        GLFW_KEY_I, GLFW_KEY_K, GLFW_KEY_J, GLFW_KEY_L, GLFW_KEY_U, GLFW_KEY_O,
+        GLFW_KEY_P, GLFW_KEY_F, GLFW_KEY_H, GLFW_KEY_G
+    };
+    InputFrame input;
+    input.deltaTime = frameDelta;
+    input.mouseX = mouseOffsetX;
+    input.mouseY = mouseOffsetY;
+    mouseOffsetX = mouseOffsetY = 0.0f;
+    for (int key = 0; key < INPUT_KEY_COUNT; ++key)
+        if (glfwGetKey(window, GLFW_KEYS[key]) == GLFW_PRESS) input.press((InputKey)key);
+    return input;
+}
+
+// Xử lý input của một frame - chỉ phụ thuộc InputFrame nên frame ghi lại cho ra đúng cùng kết quả
+// window = NULL khi phát lại trong --bench
+void processInput(GLFWwindow* window, const InputFrame& input) {
+    deltaTime = input.deltaTime;
+    if (input.mouseX != 0.0f || input.mouseY != 0.0f) camera.processMouseMovement(input.mouseX, input.mouseY);
+
     static bool escKeyPressed = false;
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS && !escKeyPressed) {
-        cout << "ESC: Thoat ung dung" << endl;
+    if (input.pressed(INPUT_KEY_ESCAPE) && !escKeyPressed) {
+        LOG_INFO("ESC: Thoat ung dung");
         escKeyPressed = true;
-        glfwSetWindowShouldClose(window, true);
+        if (window) glfwSetWindowShouldClose(window, true);
     }
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_RELEASE) {
+    if (!input.pressed(INPUT_KEY_ESCAPE)) {
         escKeyPressed = false;
     }
     
     // Camera movement
     static bool wKeyPressed = false, sKeyPressed = false, aKeyPressed = false, dKeyPressed = false;
-    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) {
+    if (input.pressed(INPUT_KEY_W)) {
         if (!wKeyPressed) {
-            cout << "W: Di chuyen camera tien" << endl;
+            LOG_DEBUG("W: Di chuyen camera tien");
             wKeyPressed = true;
         }
         camera.processKeyboard(0, deltaTime);
     } else {
         wKeyPressed = false;
     }
-    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) {
+    if (input.pressed(INPUT_KEY_S)) {
         if (!sKeyPressed) {
-            cout << "S: Di chuyen camera lui" << endl;
+            LOG_DEBUG("S: Di chuyen camera lui");
             sKeyPressed = true;
         }
         camera.processKeyboard(1, deltaTime);
     } else {
         sKeyPressed = false;
     }
-    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) {
+    if (input.pressed(INPUT_KEY_A)) {
         if (!aKeyPressed) {
-            cout << "A: Di chuyen camera trai" << endl;
+            LOG_DEBUG("A: Di chuyen camera trai");
             aKeyPressed = true;
         }
         camera.processKeyboard(2, deltaTime);
     } else {
         aKeyPressed = false;
     }
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) {
+    if (input.pressed(INPUT_KEY_D)) {
         if (!dKeyPressed) {
-            cout << "D: Di chuyen camera phai" << endl;
+            LOG_DEBUG("D: Di chuyen camera phai");
             dKeyPressed = true;
         }
         camera.processKeyboard(3, deltaTime);
@@ -105,54 +224,54 @@ void processInput(GLFWwindow* window) {
     static bool iKeyPressed = false, jKeyPressed = false, kKeyPressed = false;
     static bool lKeyPressed = false, uKeyPressed = false, oKeyPressed = false;
     
-    if (glfwGetKey(window, GLFW_KEY_I) == GLFW_PRESS) {
+    if (input.pressed(INPUT_KEY_I)) {
         if (!iKeyPressed) {
-            cout << "I: Di chuyen light tien (Z-)" << endl;
+            LOG_DEBUG("I: Di chuyen light tien (Z-)");
             iKeyPressed = true;
         }
         lightPos.z -= lightSpeed;
     } else {
         iKeyPressed = false;
     }
-    if (glfwGetKey(window, GLFW_KEY_K) == GLFW_PRESS) {
+    if (input.pressed(INPUT_KEY_K)) {
         if (!kKeyPressed) {
-            cout << "K: Di chuyen light lui (Z+)" << endl;
+            LOG_DEBUG("K: Di chuyen light lui (Z+)");
             kKeyPressed = true;
         }
         lightPos.z += lightSpeed;
     } else {
         kKeyPressed = false;
     }
-    if (glfwGetKey(window, GLFW_KEY_J) == GLFW_PRESS) {
+    if (input.pressed(INPUT_KEY_J)) {
         if (!jKeyPressed) {
-            cout << "J: Di chuyen light trai (X-)" << endl;
+            LOG_DEBUG("J: Di chuyen light trai (X-)");
             jKeyPressed = true;
         }
         lightPos.x -= lightSpeed;
     } else {
         jKeyPressed = false;
     }
-    if (glfwGetKey(window, GLFW_KEY_L) == GLFW_PRESS) {
+    if (input.pressed(INPUT_KEY_L)) {
         if (!lKeyPressed) {
-            cout << "L: Di chuyen light phai (X+)" << endl;
+            LOG_DEBUG("L: Di chuyen light phai (X+)");
             lKeyPressed = true;
         }
         lightPos.x += lightSpeed;
     } else {
         lKeyPressed = false;
     }
-    if (glfwGetKey(window, GLFW_KEY_U) == GLFW_PRESS) {
+    if (input.pressed(INPUT_KEY_U)) {
         if (!uKeyPressed) {
-            cout << "U: Di chuyen light len (Y+)" << endl;
+            LOG_DEBUG("U: Di chuyen light len (Y+)");
             uKeyPressed = true;
         }
         lightPos.y += lightSpeed;
     } else {
         uKeyPressed = false;
     }
-    if (glfwGetKey(window, GLFW_KEY_O) == GLFW_PRESS) {
+    if (input.pressed(INPUT_KEY_O)) {
         if (!oKeyPressed) {
-            cout << "O: Di chuyen light xuong (Y-)" << endl;
+            LOG_DEBUG("O: Di chuyen light xuong (Y-)");
             oKeyPressed = true;
         }
         lightPos.y -= lightSpeed;
@@ -162,75 +281,508 @@ void processInput(GLFWwindow* window) {
     
     // Toggle shading model (P key)
     static bool pKeyPressed = false;
-    if (glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS && !pKeyPressed) {
+    if (input.pressed(INPUT_KEY_P) && !pKeyPressed) {
         shadingModel = 1 - shadingModel; // Toggle between 0 and 1
         pKeyPressed = true;
-        cout << "Shading Model: " << (shadingModel == 0 ? "Lambert/Gouraud" : "Phong") << endl;
+        LOG_INFO("Shading Model: " << (shadingModel == 0 ? "Lambert/Gouraud" : "Phong"));
     }
-    if (glfwGetKey(window, GLFW_KEY_P) == GLFW_RELEASE) {
+    if (!input.pressed(INPUT_KEY_P)) {
         pKeyPressed = false;
     }
     
     // Toggle display mode (F key) - Wireframe/Flat/Smooth
     static bool fKeyPressed = false;
-    if (glfwGetKey(window, GLFW_KEY_F) == GLFW_PRESS && !fKeyPressed) {
+    if (input.pressed(INPUT_KEY_F) && !fKeyPressed) {
         displayMode = (DisplayMode)((displayMode + 1) % 3);
         fKeyPressed = true;
         const char* modeNames[] = {"Wireframe ", "Flat Shading", "Smooth Shading "};
-        cout << "Display Mode: " << modeNames[displayMode] << endl;
+        LOG_INFO("Display Mode: " << modeNames[displayMode]);
     }
-    if (glfwGetKey(window, GLFW_KEY_F) == GLFW_RELEASE) {
+    if (!input.pressed(INPUT_KEY_F)) {
         fKeyPressed = false;
     }
+
+    // Ẩn/hiện HUD hiệu năng (H key)
+    static bool hKeyPressed = false;
+    if (input.pressed(INPUT_KEY_H) && !hKeyPressed) {
+        showHud = !showHud;
+        hKeyPressed = true;
+    }
+    if (!input.pressed(INPUT_KEY_H)) {
+        hKeyPressed = false;
+    }
+
+    // In số lệnh đổi trạng thái GL của frame trước và thời gian GPU từng pass (G key)
+    static bool gKeyPressed = false;
+    if (input.pressed(INPUT_KEY_G) && !gKeyPressed) {
+        gKeyPressed = true;
+        const GLStateCache::Stats& stats = glState.lastFrameStats();
+        LOG_INFO("GL state calls: " << stats.issued << " issued, " << stats.filtered << " filtered");
+        // Thời gian GPU trung bình mỗi pass (+ số lần chạy shader nếu có pipeline statistics)
+        for (const GpuPassTimer::PassStats& pass : gpuTimer.getStats().passes) {
+            if (gpuTimer.getStats().pipelineStatistics)
+                LOG_INFO("GPU " << pass.name << ": " << pass.gpuMs << " ms, " << pass.vertexInvocations << " VS / "
+                         << pass.fragmentInvocations << " FS invocations");
+            else
+                LOG_INFO("GPU " << pass.name << ": " << pass.gpuMs << " ms");
+        }
+        const StreamingAllocator::Stats& stream = streamAllocator.getStats();
+        LOG_INFO("Stream (" << (streamAllocator.isPersistent() ? "persistent" : "map range") << "): peak "
+                 << stream.peakBytes << " / " << STREAM_BYTES_PER_FRAME << " bytes, " << stream.grown << " regions grown, "
+                 << stream.skipped << " frames skipped, " << stream.orphans << " orphans, " << stream.failed << " failed");
+    }
+    if (!input.pressed(INPUT_KEY_G)) {
+        gKeyPressed = false;
+    }
 }
 
-int main() {
+// Tài nguyên GL để vẽ một frame, tạo một lần lúc khởi động
+struct Scene {
+    ShaderPermutations& terrainShaders;
+    Shader& waterShader;
+    Shader& uiShader;
+    Shader& hudShader;
+    FrameUniformBuffer& frameUniforms;
+    unsigned int terrainVAO, waterVAO, uiVAO, uiFrameVAO, horizonTexture;
+    GLsizei terrainIndexCount;
+    Vec3 terrainBoundsMin, terrainBoundsMax;
+    Vec3 lastPos; // Vị trí camera lần cuối cập nhật đường đi trên minimap
+    size_t gpuStaticBytes; // Buffer + texture tĩnh đã upload (terrain, AO, horizon map, font)
+
+    int drawCalls = 0;          // Frame đang vẽ
+    int lastDrawCalls = 0;      // Frame trước - hiển thị trên HUD
+    long long lastTriangles = 0;
+};
+
+// Dựng HUD (chữ + đồ thị frame time) và vẽ bằng một draw call; số liệu là của frame trước
+void drawHud(Scene& scene) {
+    PROFILE_ZONE("hud");
+    const float LINE = 20.0f;
+    const float PANEL_WIDTH = 4.0f * Hud::HISTORY + 20.0f, PANEL_HEIGHT = 6 * LINE + 68.0f;
+    float x = 18.0f, y = SCR_HEIGHT - 10.0f - LINE;
+    char line[128];
+
+    hud.begin();
+    hud.rect(8.0f, SCR_HEIGHT - 8.0f - PANEL_HEIGHT, PANEL_WIDTH, PANEL_HEIGHT, 0x00000090);
+
+    float frameMs = hud.averageFrameMs();
+    snprintf(line, sizeof(line), "FPS %.0f  %.2f ms", frameMs > 0.0f ? 1000.0f / frameMs : 0.0f, frameMs);
+    hud.text(x, y, line, 0xFFFFFFFF);
+    y -= 66.0f;
+    hud.frameGraph(x, y, 4.0f * Hud::HISTORY, 60.0f, 50.0f, 1000.0f / 60.0f);
+    y -= LINE + 4.0f;
+
+    snprintf(line, sizeof(line), "Draw calls %d  Triangles %lld", scene.lastDrawCalls, scene.lastTriangles);
+    hud.text(x, y, line, 0xFFFFFFFF);
+    y -= LINE;
+    const GLStateCache::Stats& state = glState.lastFrameStats();
+    snprintf(line, sizeof(line), "GL state %u issued  %u filtered", state.issued, state.filtered);
+    hud.text(x, y, line, 0xC0C0C0FF);
+    y -= LINE;
+    const vector<GpuPassTimer::PassStats>& passes = gpuTimer.getStats().passes;
+    snprintf(line, sizeof(line), "GPU water %.2f  terrain %.2f  ui %.2f ms", passes[GPU_PASS_WATER].gpuMs,
+             passes[GPU_PASS_TERRAIN].gpuMs, passes[GPU_PASS_UI].gpuMs);
+    hud.text(x, y, line, 0xC0C0C0FF);
+    y -= LINE;
+    size_t rss = hud.sampledResidentMemory();
+    if (rss) snprintf(line, sizeof(line), "Memory %.1f MB  GPU static %.0f KB", rss / 1048576.0, scene.gpuStaticBytes / 1024.0);
+    else snprintf(line, sizeof(line), "GPU static %.0f KB", scene.gpuStaticBytes / 1024.0);
+    hud.text(x, y, line, 0xC0C0C0FF);
+
+    glState.enable(GL_BLEND);
+    scene.drawCalls += hud.draw(glState, streamAllocator, scene.hudShader, UI_ORTHO);
+    glState.disable(GL_BLEND);
+}
+
+// Vẽ một frame (3D + minimap) theo camera/đèn/chế độ hiện tại; trả về số tam giác 3D đã gửi vẽ
+// Không phụ thuộc GLFW - dùng chung cho cửa sổ và chế độ --bench
+long long renderFrame(Scene& scene, float time) {
+    PROFILE_ZONE("render");
+    long long triangles = 0;
+    scene.drawCalls = 0;
+    gpuTimer.beginFrame();
+    streamAllocator.beginFrame(glState);
+
+    // --- A. RENDER 3D SCENE ---
+    // Xóa màn hình với màu trời xanh
+    glClearColor(0.5f, 0.7f, 0.9f, 1.0f); // Màu trời xanh
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    // Bật blending cho nước trong suốt
+    glState.enable(GL_BLEND);
+    glState.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    // Tính ma trận chung
+    Mat4 view = camera.getViewMatrix();
+    const Mat4& projection = PROJECTION;
+    Frustum frustum(projection, view);
+
+    // Ghi trạng thái dùng chung một lần cho mọi program
+    FrameData frameData;
+    frameData.view = view;
+    frameData.projection = projection;
+    frameData.viewPos = camera.position;
+    frameData.lightPos = lightPos;
+    frameData.lightColor = Vec3(1.0f, 1.0f, 1.0f);
+    frameData.time = time;
+    scene.frameUniforms.update(frameData);
+    
+    // --- VẼ NƯỚC TRƯỚC (để terrain vẽ đè lên) ---
+    {
+        PROFILE_ZONE("water draw");
+        gpuTimer.begin(GPU_PASS_WATER);
+        glState.useProgram(scene.waterShader.ID);
+        scene.waterShader.setMat4("model", WATER_MODEL); // Đặt nước ở y=0
+        glState.bindVertexArray(scene.waterVAO);
+        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        triangles += 2;
+        ++scene.drawCalls;
+        gpuTimer.end(GPU_PASS_WATER);
+    }
+    
+    // --- VẼ TERRAIN ---
+    {
+        PROFILE_ZONE("terrain draw");
+        gpuTimer.begin(GPU_PASS_TERRAIN);
+        Shader& terrainShader = scene.terrainShaders.get(terrainVariantKey(displayMode, shadingModel));
+        glState.useProgram(terrainShader.ID);
+
+        //  Model là hằng biên dịch; View, Projection và ánh sáng nằm trong UBO FrameData
+        terrainShader.setMat4("model", TERRAIN_MODEL);
+        terrainShader.setMat3("normalMatrix", TERRAIN_NORMAL_MATRIX);
+
+        glState.activeTexture(GL_TEXTURE0);
+        glState.bindTexture(GL_TEXTURE_2D_ARRAY, scene.horizonTexture);
+        glState.bindVertexArray(scene.terrainVAO);
+    
+        //  Chế độ hiển thị: Wireframe/Flat/Smooth
+        if (displayMode == DISPLAY_WIREFRAME) {
+            glState.polygonMode(GL_LINE);
+            glState.lineWidth(4.0f);
+        } else {
+            // Fill mode cho Flat và Smooth
+            glState.polygonMode(GL_FILL);
+        }
+    
+        // Vẽ lưới tam giác [ - OpenGL Primitives] - bỏ qua khi terrain nằm ngoài frustum
+        if (frustum.testAabb(scene.terrainBoundsMin, scene.terrainBoundsMax)) {
+            glDrawElements(GL_TRIANGLES, scene.terrainIndexCount, GL_UNSIGNED_INT, 0);
+            triangles += scene.terrainIndexCount / 3;
+            ++scene.drawCalls;
+        }
+    
+        // Reset về fill mode sau khi vẽ (để không ảnh hưởng đến minimap)
+        if (displayMode == DISPLAY_WIREFRAME) {
+            glState.polygonMode(GL_FILL);
+        }
+        gpuTimer.end(GPU_PASS_TERRAIN);
+    }
+
+    glState.disable(GL_BLEND); // Tắt blending sau khi vẽ nước
 
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    // --- E. MINIMAP & UI (2D) ---
+    //  Phép chiếu trực giao cho Minimap
+    // Cập nhật đường đi: Áp dụng Bresenham mỗi khi di chuyển đáng kể
+    {
+        PROFILE_ZONE("minimap update");
+        if (abs(camera.position.x - scene.lastPos.x) > 0.5 || abs(camera.position.z - scene.lastPos.z) > 0.5) {
+            // Map tọa độ 3D (x, z) sang 2D minimap (0-200)
+            // Địa hình rộng 50x50 map vào 200x200 pixel, offset để đặt ở góc dưới bên phải
+            int x1 = (int)((scene.lastPos.x + 25) * 4);
+            int y1 = (int)((scene.lastPos.z + 25) * 4);
+            int x2 = (int)((camera.position.x + 25) * 4);
+            int y2 = (int)((camera.position.z + 25) * 4);
+        
+            //  Xén hình Cohen-Sutherland trước khi vẽ
+            double dx1=x1, dy1=y1, dx2=x2, dy2=y2;
+            bool visible = Algorithms2D::cohenSutherlandClip(dx1, dy1, dx2, dy2, 0, MINIMAP_SIZE, 0, MINIMAP_SIZE);
+        
+            if (visible) {
+                // Bresenham để lấy các điểm ảnh
+                minimapTrail.plot(Algorithms2D::bresenhamLine((int)dx1, (int)dy1, (int)dx2, (int)dy2));
+            }
+            scene.lastPos = camera.position;
+        }
+    }
 
-    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "3D Terrain ", NULL, NULL);
-    if (window == NULL) { cout << "Failed to create GLFW window" << endl; glfwTerminate(); return -1; }
-    glfwMakeContextCurrent(window);
-    glfwSetCursorPosCallback(window, mouse_callback);
-    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    // Vẽ Minimap & HUD - Tắt Depth Test để vẽ UI đè lên trên
+    gpuTimer.begin(GPU_PASS_UI);
+    glState.disable(GL_DEPTH_TEST);
+    {
+        PROFILE_ZONE("minimap draw");
+        // 1. Đường đi (path trace): texture bitmap, chỉ upload phần mới thay đổi
+        glState.enable(GL_BLEND);
+        minimapTrail.draw(glState, scene.hudShader, UI_ORTHO);
+        glState.disable(GL_BLEND);
+        ++scene.drawCalls;
+
+        glState.useProgram(scene.uiShader.ID);
+        scene.uiShader.setMat4("projection", UI_ORTHO);
+
+        // 2. Khung minimap: VAO riêng trỏ vào buffer tĩnh
+        glState.bindVertexArray(scene.uiFrameVAO);
+        scene.uiShader.setVec3("color", Vec3(1.0f, 1.0f, 1.0f)); // Màu trắng cho khung
+        glState.lineWidth(2.0f);
+        glDrawArrays(GL_LINES, 0, (GLsizei)MINIMAP_FRAME.size());
+        ++scene.drawCalls;
+
+        // Marker (8 điểm) + mũi tên (2 điểm) ghi thẳng vào vùng cấp phát từ stream
+        const size_t markerCount = MARKER_CIRCLE.size(), arrowCount = 2;
+        StreamingAllocator::Allocation block = streamAllocator.allocate((markerCount + arrowCount) * sizeof(Vec3), sizeof(Vec3));
+        if (block.data) {
+            Vec3* vertices = (Vec3*)block.data;
+
+            // 3. Marker cho vị trí camera hiện tại: hình tròn nhỏ - dịch bảng điểm tính sẵn lúc biên dịch
+            float camX = MINIMAP_X + (camera.position.x + 25.0f) * 4.0f;
+            float camY = MINIMAP_Y + (camera.position.z + 25.0f) * 4.0f;
+            for (size_t i = 0; i < markerCount; ++i) {
+                vertices[i] = Vec3(camX + MARKER_CIRCLE[i].x, camY + MARKER_CIRCLE[i].y, 0.0f);
+            }
 
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
-        cout << "Failed to initialize GLAD" << endl; return -1;
+            // 4. Hướng camera (mũi tên)
+            Vec3 front2D = Vec3(camera.front.x, 0.0f, camera.front.z).normalize();
+            vertices[markerCount] = Vec3(camX, camY, 0.0f);
+            vertices[markerCount + 1] = Vec3(camX + front2D.x * 8.0f, camY + front2D.z * 8.0f, 0.0f);
+            streamAllocator.commit(glState);
+
+            GLint first = (GLint)(block.offset / sizeof(Vec3));
+            glState.bindVertexArray(scene.uiVAO);
+            scene.uiShader.setVec3("color", Vec3(0.0f, 1.0f, 0.0f)); // Màu xanh lá cho camera
+            glState.pointSize(4.0f);
+            glDrawArrays(GL_POINTS, first, (GLsizei)markerCount);
+            ++scene.drawCalls;
+
+            scene.uiShader.setVec3("color", Vec3(0.0f, 1.0f, 1.0f)); // Màu cyan cho hướng
+            glState.lineWidth(2.0f);
+            glDrawArrays(GL_LINES, first + (GLint)markerCount, (GLsizei)arrowCount);
+            ++scene.drawCalls;
+        }
     }
 
-    // [CG.6 - Slide 17] Bật Z-Buffer (Depth Test)
-    glEnable(GL_DEPTH_TEST);
-    // [CG.6 - Slide 11] Bật Back-face Culling (Khử mặt sau)
-    glEnable(GL_CULL_FACE);
+    if (showHud) drawHud(scene);
+    gpuTimer.end(GPU_PASS_UI);
+    // Fence sau lệnh vẽ cuối của frame (không đặt giữa frame: driver có thể phải flush sớm)
+    streamAllocator.endFrame();
 
-    // 2. Tạo Shaders
-    Shader terrainShader("assets/terrain.vert", "assets/terrain.frag");
-    Shader waterShader("assets/water.vert", "assets/water.frag");
-    Shader uiShader("assets/ui.vert", "assets/ui.frag");
+    // Reset state
+    glState.enable(GL_DEPTH_TEST);
 
-    // 3. Tạo Địa hình (Modeling) 
-    Terrain terrain(50, 50); // Lưới 50x50
-    unsigned int VBO, VAO, EBO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
+    scene.lastDrawCalls = scene.drawCalls;
+    scene.lastTriangles = triangles;
+    return triangles;
+}
 
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, terrain.vertices.size() * sizeof(float), &terrain.vertices[0], GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, terrain.indices.size() * sizeof(unsigned int), &terrain.indices[0], GL_STATIC_DRAW);
+// Giá trị tại phân vị p (0..1) của mảng đã sắp xếp, nội suy tuyến tính
+double percentile(const vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    double pos = p * (sorted.size() - 1);
+    size_t lo = (size_t)pos;
+    size_t hi = min(lo + 1, sorted.size() - 1);
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (pos - lo);
+}
 
-    // Vị trí (Location 0)
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    // Pháp tuyến (Location 1) [CG.6 - Slide 28]
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+// --bench: bay camera theo Flythrough trong frameCount frame, đo thời gian mỗi frame (glFinish để tính cả GPU)
+// và in kết quả JSON ra stdout. Các frame warmup (JIT shader, upload lần đầu) không được tính
+// replay khác NULL: camera/đèn/chế độ lấy từ input đã ghi (--replay), số frame = số frame trong file;
+// warmup vẽ trạng thái ban đầu, chưa tiêu input nào
+int runBenchmark(Scene& scene, int frameCount, int warmupFrames, InputReplay* replay) {
+    if (replay) frameCount = (int)replay->frameCount();
+    vector<double> frameMs;
+    frameMs.reserve(frameCount);
+    long long measuredTriangles = 0;
+    double measuredMs = 0.0;
+    float replayTime = 0.0f;
+
+    for (int frame = -warmupFrames; frame < frameCount; ++frame) {
+        int pathFrame = max(frame, 0);
+        auto start = chrono::steady_clock::now();
+        PROFILE_ZONE("frame");
+        InputFrame input;
+        if (!replay) Flythrough::apply(camera, pathFrame, frameCount);
+        else if (frame >= 0 && replay->next(input)) {
+            processInput(NULL, input);
+            replayTime += input.deltaTime;
+        }
+        glState.beginFrame();
+        long long triangles = renderFrame(scene, replay ? replayTime : pathFrame / 60.0f);
+        {
+            PROFILE_ZONE("glFinish");
+            glFinish();
+        }
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        hud.addFrameTime((float)ms);
+        if (frame < 0) continue;
+        frameMs.push_back(ms);
+        measuredTriangles += triangles;
+        measuredMs += ms;
+    }
 
+    vector<double> sorted = frameMs;
+    sort(sorted.begin(), sorted.end());
+    const char* renderer = (const char*)glGetString(GL_RENDERER);
+    printf("{\n");
+    printf("  \"frames\": %d,\n  \"warmup_frames\": %d,\n", frameCount, warmupFrames);
+    printf("  \"width\": %u,\n  \"height\": %u,\n", SCR_WIDTH, SCR_HEIGHT);
+    printf("  \"renderer\": \"%s\",\n", renderer ? renderer : "unknown");
+    printf("  \"input\": \"%s\",\n", replay ? "replay" : "flythrough");
+    printf("  \"frame_ms\": {\"min\": %.3f, \"median\": %.3f, \"p95\": %.3f, \"p99\": %.3f, \"mean\": %.3f},\n",
+           sorted.empty() ? 0.0 : sorted.front(), percentile(sorted, 0.50), percentile(sorted, 0.95),
+           percentile(sorted, 0.99), frameCount > 0 ? measuredMs / frameCount : 0.0);
+    printf("  \"triangles_per_frame\": %.1f,\n", frameCount > 0 ? (double)measuredTriangles / frameCount : 0.0);
+    printf("  \"triangles_per_second\": %.0f,\n", measuredMs > 0.0 ? measuredTriangles / (measuredMs / 1000.0) : 0.0);
+    // Trung bình trượt thời gian GPU (và số lần chạy shader) của các frame cuối
+    const GpuPassTimer::Stats& gpu = gpuTimer.getStats();
+    printf("  \"gpu_passes\": [");
+    for (size_t p = 0; p < gpu.passes.size(); ++p) {
+        const GpuPassTimer::PassStats& pass = gpu.passes[p];
+        printf("%s\n    {\"name\": \"%s\", \"gpu_ms\": %.4f", p ? "," : "", pass.name.c_str(), pass.gpuMs);
+        if (gpu.pipelineStatistics)
+            printf(", \"vertex_invocations\": %.0f, \"fragment_invocations\": %.0f", pass.vertexInvocations,
+                   pass.fragmentInvocations);
+        printf("}");
+    }
+    printf("\n  ],\n");
+    // Từng frame theo thứ tự - hai lần chạy cùng đường bay / cùng file replay so sánh được theo từng frame
+    printf("  \"frame_ms_series\": [");
+    for (size_t f = 0; f < frameMs.size(); ++f) printf("%s%.3f", f ? ", " : "", frameMs[f]);
+    printf("]\n");
+    printf("}\n");
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    // --hot-reload: theo dõi thư mục shader (TERRAIN_SHADER_DIR hoặc assets/) và compile lại khi file đổi
+    // --bench [--frames N]: không mở cửa sổ, vẽ offscreen (EGL) theo đường bay cố định rồi in JSON
+    // --profile <file.json>: bật profiler CPU, ghi Chrome trace khi thoát
+    // --record <file>: ghi phím/chuột/deltaTime từng frame; --replay <file>: phát lại đúng chuỗi input đó
+    // (dùng được cùng --bench thay cho đường bay cố định)
+    bool hotReload = false;
+    bool benchMode = false;
+    int benchFrames = 600;
+    const char* profilePath = NULL;
+    const char* recordPath = NULL;
+    const char* replayPath = NULL;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--hot-reload") == 0) hotReload = true;
+        else if (strcmp(argv[i], "--bench") == 0) benchMode = true;
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) benchFrames = max(1, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc) profilePath = argv[++i];
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) recordPath = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) replayPath = argv[++i];
+    }
+    if (profilePath) {
+        Profiler::enable(true);
+        Profiler::setThreadName("main");
+    }
+#if !defined(TERRAIN_HEADLESS)
+    if (benchMode) {
+        LOG_ERROR("ERROR::BENCH::HEADLESS_UNAVAILABLE: build without EGL");
+        return -1;
+    }
+#endif
+    // Log qua luồng writer nền; chế độ bench: stdout chỉ chứa JSON, log chuyển sang stderr
+    Logger::Scope logging(benchMode ? stderr : stdout);
+
+    // Ghi/phát lại input: mở file trước khi tạo cửa sổ để lỗi đường dẫn dừng ngay
+    InputRecorder inputRecorder;
+    InputReplay inputReplay;
+    if (recordPath && (replayPath || benchMode)) {
+        LOG_ERROR("ERROR::INPUT_RECORDER::NEEDS_LIVE_INPUT: --record cannot be combined with --replay or --bench");
+        return -1;
+    }
+    if (recordPath && !inputRecorder.open(recordPath)) return -1;
+    if (replayPath) {
+        if (!inputReplay.open(replayPath)) return -1;
+        LOG_INFO("Input replay: " << inputReplay.frameCount() << " frames from " << replayPath);
+    }
+
+    StartupTimeline timeline;
+
+    // 1. Địa hình + horizon map chỉ cần CPU: chạy trên luồng riêng ngay từ đầu,
+    // chồng lên khởi tạo cửa sổ, đọc file shader và compile
+    Terrain terrain(50, 50, false); // Lưới 50x50
+    HorizonMap horizonMap;
+    thread terrainWorker([&]() {
+        if (profilePath) Profiler::setThreadName("worker");
+        {
+            StartupTimeline::Scope phase(timeline, "terrain load/generate + AO", "worker");
+            PROFILE_ZONE("terrain load/generate + AO");
+            // Đọc từ cache nếu đã bake AO từ lần chạy trước
+            if (!TerrainCache::load(TERRAIN_CACHE_PATH, terrain)) {
+                terrain.generateTerrain();
+
+                // Bake AO tĩnh một lần, song song trên các nhân CPU
+                auto bakeStart = chrono::steady_clock::now();
+                terrain.bakeAmbientOcclusion();
+                double bakeMs = chrono::duration<double, milli>(chrono::steady_clock::now() - bakeStart).count();
+                LOG_INFO("AO bake " << terrain.width << "x" << terrain.height << ": " << bakeMs << " ms ("
+                         << workerCount() << " threads)");
+
+                TerrainCache::save(TERRAIN_CACHE_PATH, terrain);
+            }
+        }
+        // Horizon map cho bóng đổ tự thân: tính trước góc chân trời theo 8 hướng,
+        // shader chỉ cần 2 lần fetch để biết fragment có bị che với mọi vị trí đèn
+        StartupTimeline::Scope phase(timeline, "horizon map build", "worker");
+        PROFILE_ZONE("horizon map build");
+        horizonMap.build(terrain);
+    });
+
+    GLFWwindow* window = NULL;
+#if defined(TERRAIN_HEADLESS)
+    HeadlessContext headless;
+#endif
+    {
+        StartupTimeline::Scope phase(timeline, benchMode ? "EGL pbuffer + GL context" : "GLFW window + GL context", "main");
+        GLADloadproc loadProc;
+        if (benchMode) {
+#if defined(TERRAIN_HEADLESS)
+            if (!headless.create(SCR_WIDTH, SCR_HEIGHT)) { terrainWorker.join(); return -1; }
+            loadProc = (GLADloadproc)HeadlessContext::procAddress;
+#endif
+        } else {
+            glfwInit();
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+            glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+            window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "3D Terrain ", NULL, NULL);
+            if (window == NULL) { LOG_ERROR("Failed to create GLFW window"); terrainWorker.join(); glfwTerminate(); return -1; }
+            glfwMakeContextCurrent(window);
+            glfwSetCursorPosCallback(window, mouse_callback);
+            glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+            loadProc = (GLADloadproc)glfwGetProcAddress;
+        }
+
+        if (!gladLoadGLLoader(loadProc)) {
+            LOG_ERROR("Failed to initialize GLAD"); terrainWorker.join(); return -1;
+        }
+        // Các hàm ngoài GL 3.3 core (program binary, parallel shader compile...) nạp tay nếu driver hỗ trợ
+        GLExtensions::load(loadProc);
+    }
+
+    // [CG.6 - Slide 17] Bật Z-Buffer (Depth Test)
+    glState.enable(GL_DEPTH_TEST);
+    // [CG.6 - Slide 11] Bật Back-face Culling (Khử mặt sau)
+    glState.enable(GL_CULL_FACE);
+
+    // 2. Tạo Shaders - nạp từ program binary cache nếu driver hỗ trợ, nếu không compile từ GLSL.
+    // Chỉ gửi lệnh compile/link (DeferLink): với KHR_parallel_shader_compile driver compile song song
+    double shaderSubmitStart = timeline.now();
+    // Terrain: một program chuyên biệt cho mỗi kiểu chiếu sáng thay vì rẽ nhánh theo uniform mỗi fragment
+    ShaderPermutations terrainShaders("assets/terrain.vert", "assets/terrain.frag", terrainVariantDefines(),
+                                      Shader::DeferLink());
+    Shader waterShader("assets/water.vert", "assets/water.frag", "", Shader::DeferLink());
+    Shader uiShader("assets/ui.vert", "assets/ui.frag", "", Shader::DeferLink());
+    Shader hudShader("assets/ui.vert", "assets/ui.frag", "#define UI_HUD\n", Shader::DeferLink());
+    timeline.record(GLExtensions::parallelShaderCompile ? "shader read + submit (parallel compile)"
+                                                        : "shader read + compile", "main", shaderSubmitStart, timeline.now());
+
+    // UBO chung cho camera + ánh sáng: terrain và nước cùng đọc block FrameData
+    FrameUniformBuffer frameUniforms;
+    frameUniforms.create();
+
+    // Water + UI không phụ thuộc terrain: tạo trong lúc worker còn chạy
     // Setup cho Water Plane - giới hạn sát terrain
     float waterSize = 26.0f; // Nửa cạnh (52x52, sát với terrain 50x50)
     float waterVertices[] = {
@@ -255,197 +807,202 @@ int main() {
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
 
-    // Setup cho Minimap (UI)
-    unsigned int uiVAO, uiVBO;
+    // Buffer chung cho mọi đỉnh động (minimap, HUD)
+    streamAllocator.create(STREAM_BYTES_PER_FRAME);
+
+    // Setup cho Minimap (UI): khung tĩnh + đỉnh động cấp phát từ streamAllocator
+    unsigned int uiFrameVAO, uiFrameVBO;
+    glGenVertexArrays(1, &uiFrameVAO);
+    glGenBuffers(1, &uiFrameVBO);
+    glBindVertexArray(uiFrameVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, uiFrameVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(MINIMAP_FRAME), MINIMAP_FRAME.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    unsigned int uiVAO;
     glGenVertexArrays(1, &uiVAO);
-    glGenBuffers(1, &uiVBO);
+    // Layout attribute là trạng thái của VAO - chỉ cần khai báo một lần (vùng của frame chọn qua "first" của glDrawArrays)
+    glBindVertexArray(uiVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, streamAllocator.buffer());
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
 
-    // Vòng lặp chính
-    Vec3 lastPos = camera.position;
-    
-    while (!glfwWindowShouldClose(window)) {
-        // Tính delta time
-        float currentFrame = glfwGetTime();
-        deltaTime = currentFrame - lastFrame;
-        lastFrame = currentFrame;
+    minimapTrail.create(MINIMAP_X, MINIMAP_Y, 0xFF0000FF); // Màu đỏ cho đường đi
 
-        processInput(window);
+    // HUD: atlas font, đỉnh cũng cấp phát từ streamAllocator
+    hud.create(streamAllocator);
 
-        // --- A. RENDER 3D SCENE ---
-        // Xóa màn hình với màu trời xanh
-        glClearColor(0.5f, 0.7f, 0.9f, 1.0f); // Màu trời xanh
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    // 3. Upload terrain ngay khi luồng worker xong
+    double terrainWaitStart = timeline.now();
+    terrainWorker.join();
+    timeline.record("wait for terrain worker", "main", terrainWaitStart, timeline.now());
 
-        // Bật blending cho nước trong suốt
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    double uploadStart = timeline.now();
+    // AABB của terrain trong world space, dùng cho frustum culling mỗi frame
+    float terrainMinY = terrain.vertices[1], terrainMaxY = terrain.vertices[1];
+    for (size_t i = 1; i < terrain.vertices.size(); i += 6) {
+        terrainMinY = min(terrainMinY, terrain.vertices[i]);
+        terrainMaxY = max(terrainMaxY, terrain.vertices[i]);
+    }
+    const Vec3 terrainBoundsMin = TERRAIN_MODEL.transformPoint(Vec3(0.0f, terrainMinY, 0.0f));
+    const Vec3 terrainBoundsMax = TERRAIN_MODEL.transformPoint(
+        Vec3((float)(terrain.width - 1), terrainMaxY, (float)(terrain.height - 1)));
 
-        // Tính ma trận chung
-        Mat4 view = camera.getViewMatrix();
-        Mat4 projection = Mat4::perspective(45.0f * PI / 180.0f, (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 200.0f);
-        
-        // --- VẼ NƯỚC TRƯỚC (để terrain vẽ đè lên) ---
-        waterShader.use();
-        Mat4 waterModel = Mat4::translate(Vec3(-25.0f, 0.0f, -25.0f)); // Đặt nước ở y=0
-        waterShader.setMat4("model", waterModel);
-        waterShader.setMat4("view", view);
-        waterShader.setMat4("projection", projection);
-        waterShader.setVec3("viewPos", camera.position);
-        waterShader.setVec3("lightPos", lightPos);
-        waterShader.setVec3("lightColor", Vec3(1.0f, 1.0f, 1.0f));
-        waterShader.setFloat("time", (float)glfwGetTime());
-        glBindVertexArray(waterVAO);
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-        
-        // --- VẼ TERRAIN ---
-        terrainShader.use();
-
-        //  Tạo các ma trận biến đổi (Model, View, Projection)
-        Mat4 model; // Identity
-        // Đặt terrain ở giữa, nổi trên mặt nước
-        model = Mat4::translate(Vec3(-25.0f, 0.0f, -25.0f));
-
-        terrainShader.setMat4("model", model);
-        terrainShader.setMat4("view", view);
-        terrainShader.setMat4("projection", projection);
-
-        // Lighting Properties - Point Light di chuyển được
-        terrainShader.setVec3("lightPos", lightPos);
-        terrainShader.setVec3("viewPos", camera.position);
-        terrainShader.setVec3("lightColor", Vec3(1.0f, 1.0f, 1.0f));
-        terrainShader.setInt("shadingModel", shadingModel); // 0 = Lambert/Gouraud, 1 = Phong
-        terrainShader.setInt("displayMode", displayMode); // 0 = Wireframe, 1 = Flat, 2 = Smooth
-
-        glBindVertexArray(VAO);
-        
-        //  Chế độ hiển thị: Wireframe/Flat/Smooth
-        if (displayMode == DISPLAY_WIREFRAME) {
-            glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-            glLineWidth(4.0f);
-        } else {
-            // Fill mode cho Flat và Smooth
-            glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-        }
-        
-        // Vẽ lưới tam giác [ - OpenGL Primitives]
-        glDrawElements(GL_TRIANGLES, terrain.indices.size(), GL_UNSIGNED_INT, 0);
-        
-        // Reset về fill mode sau khi vẽ (để không ảnh hưởng đến minimap)
-        if (displayMode == DISPLAY_WIREFRAME) {
-            glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-        }
+    unsigned int VBO, VAO, EBO, aoVBO;
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
+    glGenBuffers(1, &aoVBO);
 
-        glDisable(GL_BLEND); // Tắt blending sau khi vẽ nước
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, terrain.vertices.size() * sizeof(float), &terrain.vertices[0], GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, terrain.indices.size() * sizeof(unsigned int), &terrain.indices[0], GL_STATIC_DRAW);
 
-        // --- E. MINIMAP & UI (2D) ---
-        //  Phép chiếu trực giao cho Minimap
-        // Cập nhật đường đi: Áp dụng Bresenham mỗi khi di chuyển đáng kể
-        if (abs(camera.position.x - lastPos.x) > 0.5 || abs(camera.position.z - lastPos.z) > 0.5) {
-            // Map tọa độ 3D (x, z) sang 2D minimap (0-200)
-            // Địa hình rộng 50x50 map vào 200x200 pixel, offset để đặt ở góc dưới bên phải
-            int x1 = (int)((lastPos.x + 25) * 4);
-            int y1 = (int)((lastPos.z + 25) * 4);
-            int x2 = (int)((camera.position.x + 25) * 4);
-            int y2 = (int)((camera.position.z + 25) * 4);
-            
-            //  Xén hình Cohen-Sutherland trước khi vẽ
-            double dx1=x1, dy1=y1, dx2=x2, dy2=y2;
-            bool visible = Algorithms2D::cohenSutherlandClip(dx1, dy1, dx2, dy2, 0, MINIMAP_SIZE, 0, MINIMAP_SIZE);
-            
-            if (visible) {
-                // Bresenham để lấy các điểm ảnh
-                vector<Vec3> newPoints = Algorithms2D::bresenhamLine((int)dx1, (int)dy1, (int)dx2, (int)dy2);
-                pathTrace.insert(pathTrace.end(), newPoints.begin(), newPoints.end());
-            }
-            lastPos = camera.position;
-        }
+    // Vị trí (Location 0)
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    // Pháp tuyến (Location 1) [CG.6 - Slide 28]
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    // Ambient Occlusion đã bake (Location 2) - buffer riêng, giữ nguyên layout 6 float
+    glBindBuffer(GL_ARRAY_BUFFER, aoVBO);
+    glBufferData(GL_ARRAY_BUFFER, terrain.ambientOcclusion.size() * sizeof(float), &terrain.ambientOcclusion[0], GL_STATIC_DRAW);
+    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void*)0);
+    glEnableVertexAttribArray(2);
+
+    unsigned int horizonTexture;
+    glGenTextures(1, &horizonTexture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, horizonTexture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, horizonMap.width, horizonMap.height, HorizonMap::LAYERS,
+                 0, GL_RGBA, GL_UNSIGNED_BYTE, &horizonMap.texels[0]);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    timeline.record("terrain + horizon map upload", "main", uploadStart, timeline.now());
+
+    // 4. Chờ link xong (thường đã xong trong lúc chờ terrain), rồi thiết lập uniform dùng chung
+    double linkStart = timeline.now();
+    terrainShaders.finishLink();
+    waterShader.finishLink();
+    uiShader.finishLink();
+    hudShader.finishLink();
+    timeline.record("shader link wait", "main", linkStart, timeline.now());
+
+    int cachedPrograms = (waterShader.fromBinaryCache ? 1 : 0) + (uiShader.fromBinaryCache ? 1 : 0) +
+                         (hudShader.fromBinaryCache ? 1 : 0);
+    terrainShaders.forEach([&](Shader& shader) { cachedPrograms += shader.fromBinaryCache ? 1 : 0; });
+    LOG_INFO("Shaders: " << cachedPrograms << "/" << terrainShaders.variantCount() + 3
+             << " programs from binary cache" << (ProgramBinaryCache::available() ? "" : " (unsupported by driver)")
+             << ", parallel compile " << (GLExtensions::parallelShaderCompile ? "on" : "off"));
+    LOG_INFO("Horizon map " << HorizonMap::DIRECTIONS << " dirs " << horizonMap.width << "x" << horizonMap.height
+             << ": " << horizonMap.memoryBytes() / 1024.0 << " KB");
+    LOG_INFO("Streaming buffer: " << StreamingAllocator::FRAMES << " x " << STREAM_BYTES_PER_FRAME / 1024 << " KB, "
+             << (streamAllocator.isPersistent() ? "persistent mapped" : "map range + orphan"));
+
+    auto setupTerrainShader = [](Shader& shader) {
+        shader.bindUniformBlock(FrameUniformBuffer::BLOCK_NAME, FrameUniformBuffer::BINDING);
+        shader.use();
+        shader.setInt("horizonMap", 0); // Texture unit 0
+    };
+    auto setupWaterShader = [](Shader& shader) {
+        shader.bindUniformBlock(FrameUniformBuffer::BLOCK_NAME, FrameUniformBuffer::BINDING);
+    };
+    auto setupHudShader = [](Shader& shader) {
+        shader.use();
+        shader.setInt("fontAtlas", 1); // Texture unit 1
+    };
+    terrainShaders.forEach(setupTerrainShader);
+    setupWaterShader(waterShader);
+    setupHudShader(hudShader);
+    // Setup/upload ở trên gọi gl* trực tiếp - cache bắt đầu lại từ trạng thái chưa biết
+    glState.invalidate();
+
+    ShaderHotReload shaderReload;
+    if (hotReload) {
+        const char* shaderDir = ShaderSources::editableDirectory();
+        shaderReload.watch(terrainShaders, "assets/terrain.vert", "assets/terrain.frag", setupTerrainShader);
+        shaderReload.watch(waterShader, "assets/water.vert", "assets/water.frag", "", setupWaterShader);
+        shaderReload.watch(uiShader, "assets/ui.vert", "assets/ui.frag");
+        shaderReload.watch(hudShader, "assets/ui.vert", "assets/ui.frag", "#define UI_HUD\n", setupHudShader);
+        if (shaderReload.start(shaderDir)) LOG_INFO("Shader hot-reload: watching " << shaderDir);
+    }
 
-        // Vẽ Minimap & HUD - Tắt Depth Test để vẽ UI đè lên trên
-        glDisable(GL_DEPTH_TEST); 
-        uiShader.use();
-        Mat4 ortho = Mat4::ortho(0.0f, (float)SCR_WIDTH, 0.0f, (float)SCR_HEIGHT, -1.0f, 1.0f);
-        uiShader.setMat4("projection", ortho);
-        
-        glBindVertexArray(uiVAO);
-        glBindBuffer(GL_ARRAY_BUFFER, uiVBO);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-        glEnableVertexAttribArray(0);
-        
-        // Vị trí minimap: góc dưới bên phải
-        float minimapX = SCR_WIDTH - MINIMAP_SIZE - 20.0f;
-        float minimapY = 20.0f;
-        
-        // 1. Vẽ khung minimap (4 đường thẳng)
-        vector<Vec3> frame;
-        frame.push_back(Vec3(minimapX, minimapY, 0.0f));
-        frame.push_back(Vec3(minimapX + MINIMAP_SIZE, minimapY, 0.0f));
-        frame.push_back(Vec3(minimapX + MINIMAP_SIZE, minimapY, 0.0f));
-        frame.push_back(Vec3(minimapX + MINIMAP_SIZE, minimapY + MINIMAP_SIZE, 0.0f));
-        frame.push_back(Vec3(minimapX + MINIMAP_SIZE, minimapY + MINIMAP_SIZE, 0.0f));
-        frame.push_back(Vec3(minimapX, minimapY + MINIMAP_SIZE, 0.0f));
-        frame.push_back(Vec3(minimapX, minimapY + MINIMAP_SIZE, 0.0f));
-        frame.push_back(Vec3(minimapX, minimapY, 0.0f));
-        glBufferData(GL_ARRAY_BUFFER, frame.size() * sizeof(Vec3), &frame[0], GL_STATIC_DRAW);
-        uiShader.setVec3("color", Vec3(1.0f, 1.0f, 1.0f)); // Màu trắng cho khung
-        glLineWidth(2.0f);
-        glDrawArrays(GL_LINES, 0, frame.size());
-        
-        // 2. Vẽ đường đi (path trace) - offset vào trong khung
-        if (!pathTrace.empty()) {
-            vector<Vec3> offsetPath;
-            for (const auto& pt : pathTrace) {
-                // Map từ (0-200) sang vị trí minimap
-                float x = minimapX + pt.x;
-                float y = minimapY + pt.y;
-                offsetPath.push_back(Vec3(x, y, 0.0f));
+    Logger::flush(); // Bảng timeline ghi thẳng ra FILE*, không xen giữa các dòng log còn trong hàng đợi
+    timeline.print(benchMode ? stderr : stdout);
+
+    gpuTimer.create({ "water", "terrain", "ui" });
+
+    size_t gpuStaticBytes = (terrain.vertices.size() + terrain.ambientOcclusion.size()) * sizeof(float) +
+                            terrain.indices.size() * sizeof(unsigned int) + horizonMap.memoryBytes() +
+                            sizeof(waterVertices) + sizeof(waterIndices) + sizeof(MINIMAP_FRAME) + minimapTrail.memoryBytes() + Hud::ATLAS_WIDTH * Hud::ATLAS_HEIGHT;
+    Scene scene = { terrainShaders, waterShader, uiShader, hudShader, frameUniforms,
+                    VAO, waterVAO, uiVAO, uiFrameVAO, horizonTexture,
+                    (GLsizei)terrain.indices.size(), terrainBoundsMin, terrainBoundsMax, camera.position,
+                    gpuStaticBytes };
+
+    // Vòng lặp chính
+    int exitCode = 0;
+    if (benchMode) exitCode = runBenchmark(scene, benchFrames, 10, replayPath ? &inputReplay : NULL);
+
+    float inputTime = 0.0f; // Tổng deltaTime đã đưa vào processInput - thời gian của hoạt ảnh nước
+    while (window && !glfwWindowShouldClose(window)) {
+        // Tính delta time
+        float currentFrame = glfwGetTime();
+        float frameDelta = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+        hud.addFrameTime(frameDelta * 1000.0f);
+
+        PROFILE_ZONE("frame");
+        glState.beginFrame();
+        {
+            PROFILE_ZONE("input");
+            // Luôn đọc GLFW (bỏ offset chuột dồn lại); khi phát lại, input thật bị thay bằng frame đã ghi
+            InputFrame input = pollInput(window, frameDelta);
+            if (replayPath && !inputReplay.next(input)) {
+                LOG_INFO("Input replay finished");
+                break;
             }
-            glBufferData(GL_ARRAY_BUFFER, offsetPath.size() * sizeof(Vec3), &offsetPath[0], GL_DYNAMIC_DRAW);
-            uiShader.setVec3("color", Vec3(1.0f, 0.0f, 0.0f)); // Màu đỏ cho đường đi
-            glPointSize(2.0f);
-            glDrawArrays(GL_POINTS, 0, offsetPath.size());
+            if (recordPath) inputRecorder.write(input);
+            processInput(window, input);
+            inputTime += input.deltaTime;
         }
-        
-        // 3. Vẽ marker cho vị trí camera hiện tại
-        float camX = minimapX + (camera.position.x + 25.0f) * 4.0f;
-        float camY = minimapY + (camera.position.z + 25.0f) * 4.0f;
-        vector<Vec3> cameraMarker;
-        // Vẽ hình tròn nhỏ (8 điểm)
-        for (int i = 0; i < 8; ++i) {
-            float angle = i * 2.0f * PI / 8.0f;
-            float x = camX + cos(angle) * 3.0f;
-            float y = camY + sin(angle) * 3.0f;
-            cameraMarker.push_back(Vec3(x, y, 0.0f));
+        {
+            PROFILE_ZONE("shader hot-reload");
+            // Program vừa thay (setup gọi glUseProgram, ID cũ có thể bị tái sử dụng) -> quên program đang bind
+            if (shaderReload.update() > 0) glState.invalidate();
         }
-        glBufferData(GL_ARRAY_BUFFER, cameraMarker.size() * sizeof(Vec3), &cameraMarker[0], GL_STATIC_DRAW);
-        uiShader.setVec3("color", Vec3(0.0f, 1.0f, 0.0f)); // Màu xanh lá cho camera
-        glPointSize(4.0f);
-        glDrawArrays(GL_POINTS, 0, cameraMarker.size());
-        
-        // Vẽ hướng camera (mũi tên)
-        Vec3 front2D = Vec3(camera.front.x, 0.0f, camera.front.z).normalize();
-        vector<Vec3> directionArrow;
-        directionArrow.push_back(Vec3(camX, camY, 0.0f));
-        directionArrow.push_back(Vec3(camX + front2D.x * 8.0f, camY + front2D.z * 8.0f, 0.0f));
-        glBufferData(GL_ARRAY_BUFFER, directionArrow.size() * sizeof(Vec3), &directionArrow[0], GL_STATIC_DRAW);
-        uiShader.setVec3("color", Vec3(0.0f, 1.0f, 1.0f)); // Màu cyan cho hướng
-        glLineWidth(2.0f);
-        glDrawArrays(GL_LINES, 0, directionArrow.size());
-
-        // Reset state
-        glEnable(GL_DEPTH_TEST);
 
+        renderFrame(scene, inputTime);
+
+        PROFILE_ZONE("swap");
         glfwSwapBuffers(window);
         glfwPollEvents();
     }
 
+    if (recordPath) LOG_INFO("Input recording: " << inputRecorder.close() << " frames to " << recordPath);
+    if (profilePath && Profiler::writeChromeTrace(profilePath))
+        LOG_INFO("Profile trace: " << profilePath);
+
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
     glDeleteBuffers(1, &EBO);
+    glDeleteBuffers(1, &aoVBO);
+    glDeleteTextures(1, &horizonTexture);
+    frameUniforms.destroy();
+    gpuTimer.destroy();
+    hud.destroy();
     glDeleteVertexArrays(1, &waterVAO);
     glDeleteBuffers(1, &waterVBO);
     glDeleteBuffers(1, &waterEBO);
     glDeleteVertexArrays(1, &uiVAO);
-    glDeleteBuffers(1, &uiVBO);
-    glfwTerminate();
-    return 0;
+    glDeleteVertexArrays(1, &uiFrameVAO);
+    glDeleteBuffers(1, &uiFrameVBO);
+    streamAllocator.destroy();
+    minimapTrail.destroy();
+    if (window) glfwTerminate();
+    return exitCode;
 }
\ No newline at end of file